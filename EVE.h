@@ -1,8 +1,8 @@
 /*
 @file    EVE.h
 @brief   Contains FT80x/FT81x/BT81x API definitions
-@version 4.0
-@date    2019-04-07
+@version 4.1
+@date    2026-10-19
 @author  Rudolph Riedel
 
 @section History
@@ -48,6 +48,10 @@
 - changed OPT_FLASH to EVE_OPT_FLASH and OPT_FORMAT to EVE_OPT_FORMAT for consistency
 - added EVE_OPT_FILL which has been left out of the documentation for the BT81x so far
 - added a few BT81x specific macros
+
+4.1
+- added DL_TAG, DL_BITMAP_HANDLE, DL_LINE_WIDTH, DL_COLOR_A, DL_CALL, DL_JUMP, DL_SAVE_CONTEXT, DL_RESTORE_CONTEXT, DL_RETURN and DL_MACRO
+- added DL_VERTEX_FORMAT
 */
 
 #include "EVE_config.h"
@@ -63,6 +67,17 @@
 #define DL_END			0x21000000UL
 #define DL_BEGIN		0x1F000000UL /* requires OR'd arguments */
 #define DL_DISPLAY		0x00000000UL
+#define DL_TAG			0x03000000UL /* requires OR'd arguments */
+#define DL_BITMAP_HANDLE	0x05000000UL /* requires OR'd arguments */
+#define DL_LINE_WIDTH	0x0E000000UL /* requires OR'd arguments */
+#define DL_COLOR_A		0x10000000UL /* requires OR'd arguments */
+#define DL_CALL			0x1D000000UL /* requires OR'd arguments */
+#define DL_JUMP			0x1E000000UL /* requires OR'd arguments */
+#define DL_SAVE_CONTEXT		0x22000000UL
+#define DL_RESTORE_CONTEXT	0x23000000UL
+#define DL_RETURN		0x24000000UL
+#define DL_MACRO		0x25000000UL /* requires OR'd arguments */
+#define DL_VERTEX_FORMAT	0x27000000UL /* requires OR'd arguments, FT81x and BT81x only */
 
 #define CLR_COL              0x4
 #define CLR_STN              0x2
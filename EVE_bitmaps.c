@@ -0,0 +1,241 @@
+/*
+@file    EVE_bitmaps.c
+@brief   bitmap handle manager with the handle setup cached in RAM_G
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+Setting up a bitmap with EVE_cmd_setbitmap() for every bitmap in every frame costs about seven display-list commands each.
+The functions here assign a handle to each bitmap that is used and set up all handles at once in a prologue segment in RAM_G
+that is added to every display-list with a single CMD_APPEND.
+Drawing a bitmap then only takes a VERTEX2II, plus a BEGIN that EVE_DL_OPTIMIZE shares between bitmaps.
+When all handles are in use the one that was not used for the longest time is given to the new bitmap.
+
+EVE_segment_pool(MEM_SEGMENTS, 4096);
+EVE_bitmap_init(0x7fff); // all handles 0...14
+
+EVE_start_cmd_burst();
+EVE_cmd_dl(CMD_DLSTART);
+EVE_bitmap_prologue();
+...
+EVE_cmd_bitmap(&logo, 10, 10);
+...
+EVE_cmd_dl(CMD_SWAP);
+EVE_end_cmd_burst();
+EVE_cmd_execute();
+EVE_bitmap_update();
+
+A bitmap that gets a handle while a list is build is set up right there, EVE_bitmap_update() puts it into the prologue
+and needs to be called outside display-list building.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+#include "EVE_bitmaps.h"
+
+
+static EVE_bitmap_t *handle_owner[EVE_BITMAP_HANDLES];
+static uint16_t handle_used[EVE_BITMAP_HANDLES];	/* frame in which the handle was used last */
+static uint16_t handle_mask = 0;
+static uint16_t bitmap_frame = 0;
+static uint8_t prologue_dirty = 0;
+static EVE_segment_t prologue;
+
+
+/* handles is a bit-mask of the handles the manager can use, returns 0 if there is no space for the prologue in the segment pool */
+uint8_t EVE_bitmap_init(uint16_t handles)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_BITMAP_HANDLES; index++)
+	{
+		handle_owner[index] = 0;
+	}
+
+	handle_mask = handles & ((1U << EVE_BITMAP_HANDLES) - 1);
+	prologue_dirty = 0;
+	prologue.num = 0;
+	prologue.size = EVE_BITMAP_PROLOGUE_SIZE;
+	prologue.ptr = EVE_segment_alloc(EVE_BITMAP_PROLOGUE_SIZE);
+
+	if(prologue.ptr == EVE_SEGMENT_NONE)
+	{
+		prologue.size = 0;
+		return 0;
+	}
+
+	return 1;
+}
+
+
+static void EVE_bitmap_setup(uint8_t handle, const EVE_bitmap_t *bitmap)
+{
+	EVE_cmd_dl(BITMAP_HANDLE(handle));
+
+	#if defined (FT81X_ENABLE)
+	EVE_cmd_setbitmap(bitmap->addr, bitmap->format, bitmap->width, bitmap->height);
+	#else
+	{
+		uint32_t linestride;
+
+		switch(bitmap->format)
+		{
+			case EVE_L1:
+				linestride = (bitmap->width + 7) / 8;
+				break;
+
+			case EVE_L4:
+				linestride = (bitmap->width + 1) / 2;
+				break;
+
+			case EVE_ARGB1555:
+			case EVE_ARGB4:
+			case EVE_RGB565:
+				linestride = bitmap->width * 2UL;
+				break;
+
+			default:
+				linestride = bitmap->width;
+				break;
+		}
+
+		EVE_cmd_dl(BITMAP_SOURCE(bitmap->addr));
+		EVE_cmd_dl(BITMAP_LAYOUT(bitmap->format, linestride, bitmap->height));
+		EVE_cmd_dl(BITMAP_SIZE(EVE_NEAREST, EVE_BORDER, EVE_BORDER, bitmap->width, bitmap->height));
+	}
+	#endif
+}
+
+
+/* returns the handle for the bitmap, if it has none it gets one and is set up in the display-list that currently is build */
+uint8_t EVE_bitmap_handle(EVE_bitmap_t *bitmap)
+{
+	uint16_t age;
+	uint16_t oldest = 0;
+	uint8_t victim = EVE_BITMAP_HANDLES;
+	uint8_t index;
+
+	if((bitmap->handle != 0) && (handle_owner[bitmap->handle - 1] == bitmap))
+	{
+		handle_used[bitmap->handle - 1] = bitmap_frame;
+		return bitmap->handle - 1;
+	}
+
+	for(index = 0; index < EVE_BITMAP_HANDLES; index++)
+	{
+		if((handle_mask & (1U << index)) == 0)
+		{
+			continue;
+		}
+
+		if(handle_owner[index] == 0)
+		{
+			victim = index;
+			break;
+		}
+
+		age = (bitmap_frame - handle_used[index]) + 1; /* +1 so handles that were used in this frame already can be replaced as last resort */
+
+		if(age > oldest)
+		{
+			oldest = age;
+			victim = index;
+		}
+	}
+
+	if(victim == EVE_BITMAP_HANDLES) /* no handles to manage */
+	{
+		return 0;
+	}
+
+	if(handle_owner[victim] != 0)
+	{
+		handle_owner[victim]->handle = 0;
+	}
+
+	handle_owner[victim] = bitmap;
+	handle_used[victim] = bitmap_frame;
+	bitmap->handle = victim + 1;
+	prologue_dirty = 1;
+
+	EVE_bitmap_setup(victim, bitmap);
+	return victim;
+}
+
+
+void EVE_bitmap_release(EVE_bitmap_t *bitmap)
+{
+	if((bitmap->handle != 0) && (handle_owner[bitmap->handle - 1] == bitmap))
+	{
+		handle_owner[bitmap->handle - 1] = 0;
+		prologue_dirty = 1;
+	}
+
+	bitmap->handle = 0;
+}
+
+
+/* add the setup for all handles to the display-list, meant to be called right after CMD_DLSTART */
+void EVE_bitmap_prologue(void)
+{
+	EVE_segment_append(&prologue);
+}
+
+
+/* re-build the prologue when handles were assigned, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_bitmap_update(void)
+{
+	uint8_t index;
+
+	bitmap_frame++;
+
+	if((prologue_dirty == 0) || (prologue.size == 0))
+	{
+		return;
+	}
+
+	EVE_segment_start();
+
+	for(index = 0; index < EVE_BITMAP_HANDLES; index++)
+	{
+		if(handle_owner[index] != 0)
+		{
+			EVE_bitmap_setup(index, handle_owner[index]);
+		}
+	}
+
+	if(EVE_segment_end(&prologue) != 0)
+	{
+		prologue_dirty = 0;
+	}
+}
+
+
+/* draw the bitmap at x0 / y0 */
+void EVE_cmd_bitmap(EVE_bitmap_t *bitmap, int16_t x0, int16_t y0)
+{
+	uint8_t handle;
+
+	handle = EVE_bitmap_handle(bitmap);
+	EVE_cmd_dl(DL_BEGIN | EVE_BITMAPS);
+
+	if((x0 >= 0) && (x0 < 512) && (y0 >= 0) && (y0 < 512))
+	{
+		EVE_cmd_dl(VERTEX2II(x0, y0, handle, 0));
+	}
+	else
+	{
+		EVE_cmd_dl(BITMAP_HANDLE(handle));
+		EVE_cmd_dl(EVE_vertex_pixel(x0, y0));
+	}
+
+	EVE_cmd_dl(DL_END);
+}
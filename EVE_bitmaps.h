@@ -0,0 +1,37 @@
+/*
+@file    EVE_bitmaps.h
+@brief   prototypes for the bitmap handle manager
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_BITMAPS_H_
+#define EVE_BITMAPS_H_
+
+#define EVE_BITMAP_HANDLES 15		/* handles 0...14, 15 is used by the co-processor and 16...31 are the ROM fonts */
+#define EVE_BITMAP_PROLOGUE_SIZE (EVE_BITMAP_HANDLES * 32)
+
+typedef struct
+{
+	uint32_t addr;		/* address in RAM_G */
+	uint16_t format;
+	uint16_t width;
+	uint16_t height;
+	uint8_t handle;		/* managed by EVE_bitmaps.c, 0 for no handle or the assigned handle + 1 */
+} EVE_bitmap_t;
+
+uint8_t EVE_bitmap_init(uint16_t handles);
+uint8_t EVE_bitmap_handle(EVE_bitmap_t *bitmap);
+void EVE_bitmap_release(EVE_bitmap_t *bitmap);
+void EVE_bitmap_prologue(void);
+void EVE_bitmap_update(void);
+void EVE_cmd_bitmap(EVE_bitmap_t *bitmap, int16_t x0, int16_t y0);
+
+#endif /* EVE_BITMAPS_H_ */
@@ -0,0 +1,241 @@
+/*
+@file    EVE_chart.c
+@brief   streaming chart, the vertices are kept in a ring in RAM_G and only new samples are written
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+A scrolling line strip that is build with EVE_cmd_dl(VERTEX2F(...)) sends every vertex again for every frame.
+Here every point of the chart is written to a ring in RAM_G once, as a VERTEX2F word with its x coordinate
+relative to the start of the ring. The strip is added to the display-list with CMD_APPEND,
+when the ring is full that is two spans, from the oldest point to the end of the ring and from the start of the ring
+to the newest point, each span is moved to its place with VERTEX_TRANSLATE_X.
+So scrolling only takes two VERTEX_TRANSLATE_X and two CMD_APPEND and a new sample only writes four bytes.
+
+With decimate set to more than 1 a point is made from that many samples and the minimum and maximum of them
+are written as two vertices, a long history then still fits into the display-list.
+The display-list needs 4 bytes for every vertex in the ring, EVE_DL_BUDGET takes that into account.
+
+EVE_chart_t chart = {0, 60, 480, 200, -1000, 1000, 240, 4};
+
+EVE_segment_pool(MEM_SEGMENTS, 32768);
+EVE_chart_init(&chart);
+...
+EVE_chart_push(&chart, value);
+...
+EVE_cmd_dl(DL_COLOR_RGB | YELLOW);
+EVE_cmd_dl(LINE_WIDTH(16));
+EVE_chart_draw(&chart);
+
+EVE_chart_push() writes to RAM_G directly, it is meant to be called outside display-list building, does not support cmd-burst.
+This needs VERTEX_FORMAT and VERTEX_TRANSLATE_X so it is only available for FT81x and BT81x.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+#include "EVE_chart.h"
+
+#if defined (FT81X_ENABLE)
+
+/* the position of a point in 1/16 pixel from the start of the ring */
+static uint32_t EVE_chart_pos(const EVE_chart_t *chart, uint32_t point)
+{
+	return (point * chart->step) >> 8;
+}
+
+
+/* reserves space for the ring in the segment pool, returns 0 if there is not enough space left */
+uint8_t EVE_chart_init(EVE_chart_t *chart)
+{
+	uint32_t limit;
+
+	if(chart->points < 2)
+	{
+		chart->points = 2;
+	}
+
+	chart->words = (chart->decimate > 1) ? 2 : 1;
+	chart->step = ((uint32_t) chart->w0 << 12) / (chart->points - 1U); /* 1/16 pixel with 8 fractional bits */
+
+	/* VERTEX2F has 15 bits, use the best precision for which the ring and the area still fit */
+	limit = (uint32_t) chart->w0 + (chart->w0 / (chart->points - 1U)) + 1U;
+
+	if(limit < (uint32_t) (chart->y0 + chart->h0))
+	{
+		limit = (uint32_t) (chart->y0 + chart->h0);
+	}
+
+	chart->frac = 4;
+
+	while((chart->frac != 0) && ((limit << chart->frac) > 16383UL))
+	{
+		chart->frac--;
+	}
+
+	chart->ring = EVE_segment_alloc((uint32_t) chart->points * chart->words * 4U);
+	EVE_chart_clear(chart);
+
+	if(chart->ring == EVE_SEGMENT_NONE)
+	{
+		chart->points = 0;
+		return 0;
+	}
+
+	return 1;
+}
+
+
+void EVE_chart_clear(EVE_chart_t *chart)
+{
+	chart->head = 0;
+	chart->count = 0;
+	chart->bucket = 0;
+}
+
+
+static uint32_t EVE_chart_vertex(const EVE_chart_t *chart, uint32_t x16, int32_t value)
+{
+	int32_t ypos;
+
+	if(value < chart->min)
+	{
+		value = chart->min;
+	}
+
+	if(value > chart->max)
+	{
+		value = chart->max;
+	}
+
+	ypos = chart->y0 + chart->h0 - 1;
+
+	if(chart->max > chart->min)
+	{
+		ypos -= (int32_t) (((int64_t) (value - chart->min) * (chart->h0 - 1)) / ((int64_t) chart->max - chart->min));
+	}
+
+	return VERTEX2F(x16 >> (4 - chart->frac), (uint32_t) ypos << chart->frac);
+}
+
+
+/* add a sample, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_chart_push(EVE_chart_t *chart, int32_t value)
+{
+	uint32_t address;
+	uint32_t x16;
+
+	if(chart->points == 0)
+	{
+		return;
+	}
+
+	if(chart->words == 2)
+	{
+		if(chart->bucket == 0)
+		{
+			chart->low = value;
+			chart->high = value;
+		}
+		else
+		{
+			if(value < chart->low)
+			{
+				chart->low = value;
+			}
+
+			if(value > chart->high)
+			{
+				chart->high = value;
+			}
+		}
+
+		chart->bucket++;
+
+		if(chart->bucket < chart->decimate)
+		{
+			return;
+		}
+
+		chart->bucket = 0;
+	}
+
+	address = chart->ring + ((uint32_t) chart->head * chart->words * 4U);
+	x16 = EVE_chart_pos(chart, chart->head);
+
+	if(chart->words == 2)
+	{
+		EVE_memWrite32(address, EVE_chart_vertex(chart, x16, chart->low));
+		EVE_memWrite32(address + 4, EVE_chart_vertex(chart, x16, chart->high));
+	}
+	else
+	{
+		EVE_memWrite32(address, EVE_chart_vertex(chart, x16, value));
+	}
+
+	chart->head++;
+
+	if(chart->head >= chart->points)
+	{
+		chart->head = 0;
+	}
+
+	if(chart->count < chart->points)
+	{
+		chart->count++;
+	}
+}
+
+
+/* add the chart as a line strip to the display-list that currently is build, it uses the current color and line width */
+void EVE_chart_draw(const EVE_chart_t *chart)
+{
+	uint32_t size;
+	int32_t x16;
+
+	if(chart->count == 0)
+	{
+		return;
+	}
+
+	size = (uint32_t) chart->words * 4U;
+	x16 = (int32_t) chart->x0 * 16;
+
+	EVE_cmd_dl(DL_SAVE_CONTEXT);
+	EVE_cmd_dl(SCISSOR_XY(chart->x0, chart->y0));
+	EVE_cmd_dl(SCISSOR_SIZE(chart->w0, chart->h0));
+	EVE_cmd_dl(VERTEX_FORMAT(chart->frac));
+	EVE_cmd_dl(DL_BEGIN | EVE_LINE_STRIP);
+
+	if(chart->count < chart->points)
+	{
+		/* the ring is not full yet, the chart grows from the left */
+		EVE_cmd_dl(VERTEX_TRANSLATE_X((uint32_t) x16));
+		EVE_cmd_append(chart->ring, chart->count * size);
+	}
+	else
+	{
+		/* from the oldest point at the left edge to the end of the ring */
+		EVE_cmd_dl(VERTEX_TRANSLATE_X((uint32_t) (x16 - (int32_t) EVE_chart_pos(chart, chart->head))));
+		EVE_cmd_append(chart->ring + (chart->head * size), (uint32_t) (chart->points - chart->head) * size);
+
+		if(chart->head != 0)
+		{
+			/* and from the start of the ring to the newest point, the strip continues across the VERTEX_TRANSLATE_X */
+			EVE_cmd_dl(VERTEX_TRANSLATE_X((uint32_t) (x16 + (int32_t) EVE_chart_pos(chart, chart->points) - (int32_t) EVE_chart_pos(chart, chart->head))));
+			EVE_cmd_append(chart->ring, chart->head * size);
+		}
+	}
+
+	EVE_cmd_dl(DL_END);
+	EVE_cmd_dl(DL_RESTORE_CONTEXT);
+}
+
+#endif /* FT81X_ENABLE */
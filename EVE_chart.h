@@ -0,0 +1,48 @@
+/*
+@file    EVE_chart.h
+@brief   prototypes for the streaming chart with its vertices in a ring in RAM_G
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_CHART_H_
+#define EVE_CHART_H_
+
+#if defined (FT81X_ENABLE)
+
+typedef struct
+{
+	int16_t x0;		/* area on the screen */
+	int16_t y0;
+	uint16_t w0;
+	uint16_t h0;
+	int32_t min;	/* the values from min to max are mapped to the height of the chart */
+	int32_t max;
+	uint16_t points;	/* number of points across the width */
+	uint8_t decimate;	/* samples per point, the minimum and maximum of these are drawn, 0 or 1 draws every sample */
+	uint32_t ring;	/* the rest is managed by EVE_chart.c */
+	uint32_t step;
+	uint16_t head;
+	uint16_t count;
+	int32_t low;
+	int32_t high;
+	uint8_t bucket;
+	uint8_t words;
+	uint8_t frac;
+} EVE_chart_t;
+
+uint8_t EVE_chart_init(EVE_chart_t *chart);
+void EVE_chart_clear(EVE_chart_t *chart);
+void EVE_chart_push(EVE_chart_t *chart, int32_t value);
+void EVE_chart_draw(const EVE_chart_t *chart);
+
+#endif /* FT81X_ENABLE */
+
+#endif /* EVE_CHART_H_ */
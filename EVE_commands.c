@@ -1,8 +1,8 @@
 /*
 @file    EVE_commands.c
 @brief   contains FT8xx / BT8xx functions
-@version 4.0
-@date    2019-04-07
+@version 4.1
+@date    2026-10-19
 @author  Rudolph Riedel
 
 This file needs to be renamed to EVE_command.cpp for use with Arduino.
@@ -131,10 +131,27 @@ This file needs to be renamed to EVE_command.cpp for use with Arduino.
 	EVE_cmd_animframe(), EVE_cmd_gradienta(), EVE_cmd_fillwidth() and EVE_cmd_appendf()
 - upgraded EVE_get_touch_tag() to multi-touch
 
+4.1
+- added optional display-list optimizer, enabled with EVE_DL_OPTIMIZE in EVE_config.h, EVE_cmd_dl() drops commands that would not change
+	the graphics-state and holds back DL_END so that following primitives of the same kind can share a single BEGIN
+- added EVE_report_dl_saved()
+- EVE_cmd_point(), EVE_cmd_line() and EVE_cmd_rect() go thru EVE_cmd_dl() when EVE_DL_OPTIMIZE is active
+- added batch meta-commands EVE_cmd_points(), EVE_cmd_lines() and EVE_cmd_rects() plus EVE_cmd_vertices() and EVE_vertex2f_pack()
+- added EVE_cmd_vertex() which picks VERTEX2II or VERTEX2F with the smallest VERTEX_FORMAT that keeps the precision,
+	the current VERTEX_FORMAT is tracked and the meta-commands use it now as well instead of always using VERTEX2F(x*16, y*16)
+- added optional display-list budget, enabled with EVE_DL_BUDGET in EVE_config.h, the size the co-processor will expand the
+	current list to is estimated while it is build, added EVE_dl_cost(), EVE_report_dl_estimate(), EVE_dl_budget_left() and EVE_dl_budget_warning()
+- the colors set with EVE_cmd_fgcolor(), EVE_cmd_bgcolor() and EVE_cmd_gradcolor() are tracked now, added EVE_report_copro_colors()
+- added EVE_memWrite_sram_buffer()
+- added EVE_start_cmd_stage() and EVE_end_cmd_stage() for the frame pipeline, enabled with EVE_PIPELINE in EVE_config.h
+- added macro bindings EVE_macro_bind(), EVE_macro_release(), EVE_macro_set() and EVE_cmd_macro()
+- added EVE_cmd_videoframe() (FT81x)
+
 */
 
 #include "EVE.h"
 #include "EVE_config.h"
+#include "EVE_commands.h"
 #include "EVE_target.h"
 
 
@@ -146,6 +163,39 @@ volatile uint16_t cmdOffset = 0x0000;	/* used to navigate command ring buffer */
 
 volatile uint8_t cmd_burst = 0; /* flag to indicate cmd-burst is active */
 
+/* last colors send to the co-processor for its widgets, initialized with the reset-defaults */
+static uint32_t copro_fgcolor = 0x003870UL;
+static uint32_t copro_bgcolor = 0x002040UL;
+static uint32_t copro_gradcolor = 0xffffffUL;
+
+#if defined (EVE_PIPELINE)
+static uint8_t *stage_buffer = 0;	/* staging buffer for the frame that currently is encoded, 0 while commands go out directly */
+static uint16_t stage_index = 0;
+static uint16_t stage_offset = 0;	/* cmdOffset at the start of the staged frame */
+
+static inline void EVE_stage_transmit_async(uint8_t data)
+{
+	if(stage_buffer != 0)
+	{
+		if(stage_index < EVE_PIPE_BUFFER)
+		{
+			stage_buffer[stage_index++] = data;
+		}
+		else
+		{
+			stage_index = EVE_PIPE_BUFFER + 1; /* overflow */
+		}
+	}
+	else
+	{
+		spi_transmit_async(data);
+	}
+}
+
+/* everything that is send in cmd-burst mode goes thru here, while a frame is staged it goes to the staging buffer */
+#define spi_transmit_async(data) EVE_stage_transmit_async(data)
+#endif
+
 
 void EVE_cmdWrite(uint8_t data)
 {
@@ -260,6 +310,25 @@ void EVE_memWrite_flash_buffer(uint32_t ftAddress, const uint8_t *data, uint16_t
 }
 
 
+/* same as EVE_memWrite_flash_buffer() but for data in RAM, len is not rounded up */
+void EVE_memWrite_sram_buffer(uint32_t ftAddress, const uint8_t *data, uint16_t len)
+{
+	uint16_t count;
+
+	EVE_cs_set();
+	spi_transmit((uint8_t)(ftAddress >> 16) | MEM_WRITE);
+	spi_transmit((uint8_t)(ftAddress >> 8));
+	spi_transmit((uint8_t)(ftAddress));
+
+	for(count=0;count<len;count++)
+	{
+		spi_transmit(data[count]);
+	}
+
+	EVE_cs_clear();
+}
+
+
 
 /* Check if the graphics processor completed executing the current command list. */
 /* This is the case when REG_CMD_READ matches cmdOffset, indicating that all commands have been executed. */
@@ -654,6 +723,27 @@ void EVE_cmd_mediafifo(uint32_t ptr, uint32_t size)
 	EVE_inc_cmdoffset(8);
 	EVE_cs_clear();
 }
+
+
+/* decodes the next frame of an AVI from the Media-FIFO to dest, the co-processor writes 0 to the 32 bit at ptr after the last frame */
+/* this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_cmd_videoframe(uint32_t dest, uint32_t ptr)
+{
+	EVE_begin_cmd(CMD_VIDEOFRAME);
+
+	spi_transmit((uint8_t)(dest));
+	spi_transmit((uint8_t)(dest >> 8));
+	spi_transmit((uint8_t)(dest >> 16));
+	spi_transmit((uint8_t)(dest >> 24));
+
+	spi_transmit((uint8_t)(ptr));
+	spi_transmit((uint8_t)(ptr >> 8));
+	spi_transmit((uint8_t)(ptr >> 16));
+	spi_transmit((uint8_t)(ptr >> 24));
+
+	EVE_inc_cmdoffset(8);
+	EVE_cs_clear();
+}
 #endif
 
 
@@ -1175,11 +1265,67 @@ void EVE_end_cmd_burst(void)
 }
 
 
+#if defined (EVE_PIPELINE)
+/*
+These work like EVE_start_cmd_burst() and EVE_end_cmd_burst() but nothing is send, the commands are written to buffer
+which needs to have space for EVE_PIPE_BUFFER bytes.
+cmdOffset is advanced as usual so the buffer needs to be written to the command-fifo at the offset that was current
+when EVE_start_cmd_stage() was called and before anything else is written to the command-fifo, see EVE_pipeline.c.
+EVE_end_cmd_stage() returns the number of bytes in the buffer, or 0 if it overflowed in which case cmdOffset is set back.
+*/
+void EVE_start_cmd_stage(uint8_t *buffer)
+{
+	stage_buffer = buffer;
+	stage_index = 0;
+	stage_offset = cmdOffset;
+	cmd_burst = 42;
+}
+
+
+uint16_t EVE_end_cmd_stage(void)
+{
+	cmd_burst = 0;
+	stage_buffer = 0;
+
+	if(stage_index > EVE_PIPE_BUFFER)
+	{
+		cmdOffset = stage_offset;
+		return 0;
+	}
+
+	return stage_index;
+}
+#endif
+
+
+#if defined (EVE_DL_OPTIMIZE)
+static void EVE_dl_state_cmd(uint32_t command);
+#endif
+#if defined (EVE_DL_BUDGET)
+static void EVE_dl_budget_cmd(uint32_t command);
+static void EVE_dl_budget_add(uint32_t bytes);
+#endif
+static void EVE_vertex_state(uint32_t command);
+
+
 /* Begin a co-processor command */
 void EVE_start_cmd(uint32_t command)
 {
 	uint32_t ftAddress;
 
+	#if defined (EVE_DL_OPTIMIZE)
+	if((command & 0xFFFFFF00UL) == 0xFFFFFF00UL) /* co-processor command */
+	{
+		EVE_dl_state_cmd(command);
+	}
+	#endif
+
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_cmd(command);
+	#endif
+
+	EVE_vertex_state(command);
+
 	if(cmd_burst == 0)
 	{
 		ftAddress = EVE_RAM_CMD + cmdOffset;
@@ -1205,6 +1351,375 @@ void EVE_start_cmd(uint32_t command)
 }
 
 
+/* write a single 32 bit command to the command-fifo, in burst-mode or as a transfer of its own */
+void EVE_dl_write(uint32_t command)
+{
+	EVE_start_cmd(command);
+	if(cmd_burst == 0)
+	{
+		EVE_cs_clear();
+	}
+}
+
+
+#if defined (EVE_DL_OPTIMIZE)
+
+/* display-list optimizer */
+/* The graphics-state that is set with the display-list commands below is tracked while the list is build,
+	a command that would set a value that already is active is not send at all.
+	DL_END is held back until it is clear that it is needed, a BEGIN for the same primitive right after it cancels out both.
+	A vertex always needs a preceding BEGIN for this to work. */
+
+#define EVE_DL_STATE_COLOR_RGB		0
+#define EVE_DL_STATE_COLOR_A		1
+#define EVE_DL_STATE_LINE_WIDTH		2
+#define EVE_DL_STATE_POINT_SIZE		3
+#define EVE_DL_STATE_TAG			4
+#define EVE_DL_STATE_BITMAP_HANDLE	5
+#define EVE_DL_STATE_BEGIN			6
+#define EVE_DL_STATE_VERTEX_FORMAT	7
+#define EVE_DL_STATE_NUM			8
+
+static uint32_t dl_state[EVE_DL_STATE_NUM]; /* last command written for each tracked value, 0 for unknown */
+static uint8_t dl_end_pending = 0; /* DL_END was requested but not send, yet */
+static uint16_t dl_saved = 0; /* amount of bytes dropped since the last CMD_DLSTART */
+
+
+static void EVE_dl_state_reset(void)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_DL_STATE_NUM; index++)
+	{
+		dl_state[index] = 0;
+	}
+}
+
+
+/* send a DL_END that was held back */
+static void EVE_dl_flush_end(void)
+{
+	if(dl_end_pending)
+	{
+		dl_end_pending = 0;
+		dl_state[EVE_DL_STATE_BEGIN] = 0;
+		dl_saved -= 4; /* was counted as dropped */
+		EVE_dl_write(DL_END);
+	}
+}
+
+
+/* called by EVE_start_cmd() for every co-processor command, widgets leave the graphics-state in an unknown condition */
+static void EVE_dl_state_cmd(uint32_t command)
+{
+	switch(command)
+	{
+		case CMD_DLSTART:
+			dl_saved = 0;
+			dl_end_pending = 0;
+			EVE_dl_state_reset();
+			break;
+
+		case CMD_SWAP:
+			dl_end_pending = 0;
+			EVE_dl_state_reset();
+			break;
+
+		/* these do not touch the tracked graphics-state */
+		case CMD_FGCOLOR:
+		case CMD_BGCOLOR:
+		case CMD_GRADCOLOR:
+		case CMD_LOADIDENTITY:
+		case CMD_TRANSLATE:
+		case CMD_SCALE:
+		case CMD_ROTATE:
+		case CMD_SETMATRIX:
+		#if defined (FT81X_ENABLE)
+		case CMD_SETBASE:
+		case CMD_SETBITMAP:
+		#endif
+			break;
+
+		default:
+			EVE_dl_flush_end();
+			EVE_dl_state_reset();
+			break;
+	}
+}
+
+
+/* returns 0 if the command can be dropped */
+static uint8_t EVE_dl_optimize(uint32_t command)
+{
+	uint8_t slot;
+
+	if((command & 0xFFFFFF00UL) == 0xFFFFFF00UL) /* co-processor command, taken care of by EVE_start_cmd() */
+	{
+		return 1;
+	}
+
+	if((command & 0xC0000000UL) != 0) /* VERTEX2F or VERTEX2II */
+	{
+		EVE_dl_flush_end();
+		return 1;
+	}
+
+	switch(command >> 24)
+	{
+		case (DL_COLOR_RGB >> 24):
+			slot = EVE_DL_STATE_COLOR_RGB;
+			break;
+		case (DL_COLOR_A >> 24):
+			slot = EVE_DL_STATE_COLOR_A;
+			break;
+		case (DL_LINE_WIDTH >> 24):
+			slot = EVE_DL_STATE_LINE_WIDTH;
+			break;
+		case (DL_POINT_SIZE >> 24):
+			slot = EVE_DL_STATE_POINT_SIZE;
+			break;
+		case (DL_TAG >> 24):
+			slot = EVE_DL_STATE_TAG;
+			break;
+		case (DL_BITMAP_HANDLE >> 24):
+			slot = EVE_DL_STATE_BITMAP_HANDLE;
+			break;
+		case (DL_VERTEX_FORMAT >> 24):
+			slot = EVE_DL_STATE_VERTEX_FORMAT;
+			break;
+
+		case (DL_BEGIN >> 24):
+			dl_end_pending = 0; /* END + BEGIN for the same primitive cancel out and a BEGIN for a different one makes the END obsolete */
+			if(dl_state[EVE_DL_STATE_BEGIN] == command)
+			{
+				dl_saved += 4;
+				return 0;
+			}
+			dl_state[EVE_DL_STATE_BEGIN] = command;
+			return 1;
+
+		case (DL_END >> 24):
+			dl_end_pending = 1; /* keep the primitive in dl_state[] until we know that the END is needed */
+			dl_saved += 4;
+			return 0;
+
+		case (DL_DISPLAY >> 24):
+			dl_end_pending = 0;
+			EVE_dl_state_reset();
+			return 1;
+
+		case (DL_SAVE_CONTEXT >> 24):
+			EVE_dl_flush_end();
+			return 1;
+
+		case (DL_RESTORE_CONTEXT >> 24):
+		case (DL_CALL >> 24):
+		case (DL_JUMP >> 24):
+		case (DL_RETURN >> 24):
+		case (DL_MACRO >> 24):
+			EVE_dl_flush_end();
+			EVE_dl_state_reset();
+			return 1;
+
+		default:
+			return 1;
+	}
+
+	if(dl_state[slot] == command)
+	{
+		dl_saved += 4;
+		return 0;
+	}
+
+	dl_state[slot] = command;
+	return 1;
+}
+
+
+/* make the amount of bytes that were dropped from the current display-list available */
+uint16_t EVE_report_dl_saved(void)
+{
+	return dl_saved;
+}
+
+#endif
+
+
+#if defined (EVE_DL_BUDGET)
+
+/* display-list budget */
+/* The co-processor expands its commands into RAM_DL which only has EVE_RAM_DL_SIZE bytes, whatever does not fit is lost.
+	The size of the list is estimated while it is build: display-list commands count with their own four bytes,
+	CMD_APPEND and CMD_APPENDF with the number of bytes that are appended and all other co-processor commands with the values
+	from the table in EVE_dl_cost_lookup() plus a cost per character for commands with a string argument.
+	The values for the widgets are on the safe side, REG_CMD_DL has the real size after the list was executed.
+	Parts of a screen that rarely change can be moved to RAM_G with the functions in EVE_segments.c,
+	appending these only costs the size they really have. */
+
+static uint16_t dl_estimate = 0;
+static uint8_t dl_cost_per_char = 0; /* cost per character for the string argument of the last command */
+
+
+/* cost table, bytes in RAM_DL for the co-processor command itself and for each character of its string argument */
+static uint16_t EVE_dl_cost_lookup(uint32_t command, uint8_t *per_char)
+{
+	*per_char = 0;
+
+	switch(command)
+	{
+		case CMD_TEXT:
+			*per_char = 4;
+			return 24;
+
+		case CMD_BUTTON:
+		case CMD_TOGGLE:
+			*per_char = 4;
+			return 128;
+
+		case CMD_KEYS:
+			*per_char = 112;
+			return 24;
+
+		case CMD_NUMBER:
+			return 68;
+
+		case CMD_CLOCK:
+			return 560;
+
+		case CMD_GAUGE:
+			return 400;
+
+		case CMD_SPINNER:
+			return 280;
+
+		case CMD_DIAL:
+		case CMD_SLIDER:
+		case CMD_SCROLLBAR:
+			return 128;
+
+		case CMD_PROGRESS:
+		case CMD_CALIBRATE:
+			return 80;
+
+		case CMD_GRADIENT:
+			return 56;
+
+		case CMD_SETMATRIX:
+			return 24;
+
+		#if defined (FT81X_ENABLE)
+		case CMD_SETBITMAP:
+		case CMD_SETFONT2:
+			return 28;
+		#endif
+
+		#if defined (BT81X_ENABLE)
+		case CMD_GRADIENTA:
+			return 64;
+
+		case CMD_BITMAP_TRANSFORM:
+			return 24;
+
+		case CMD_ANIMDRAW:
+		case CMD_ANIMFRAME:
+			return 64;
+		#endif
+
+		default:
+			return 0;
+	}
+}
+
+
+/* estimated size a co-processor command expands to, chars is the length of its string argument */
+/* example: if(EVE_dl_cost(CMD_BUTTON, 8) > EVE_dl_budget_left()) */
+uint16_t EVE_dl_cost(uint32_t command, uint16_t chars)
+{
+	uint8_t per_char;
+	uint32_t cost;
+
+	if((command & 0xFFFFFF00UL) != 0xFFFFFF00UL) /* display-list command */
+	{
+		return 4;
+	}
+
+	cost = EVE_dl_cost_lookup(command, &per_char);
+	cost += (uint32_t) per_char * chars;
+
+	if(cost > 0xFFFF)
+	{
+		cost = 0xFFFF;
+	}
+
+	return (uint16_t) cost;
+}
+
+
+static void EVE_dl_budget_add(uint32_t bytes)
+{
+	bytes += dl_estimate;
+
+	if(bytes > 0xFFFF)
+	{
+		bytes = 0xFFFF;
+	}
+
+	dl_estimate = (uint16_t) bytes;
+}
+
+
+static void EVE_dl_budget_cmd(uint32_t command)
+{
+	if((command & 0xFFFFFF00UL) != 0xFFFFFF00UL) /* display-list command */
+	{
+		EVE_dl_budget_add(4);
+		return;
+	}
+
+	if(command == CMD_DLSTART)
+	{
+		dl_estimate = 0;
+		dl_cost_per_char = 0;
+		return;
+	}
+
+	EVE_dl_budget_add(EVE_dl_cost_lookup(command, &dl_cost_per_char));
+}
+
+
+/* estimated size of the display-list since the last CMD_DLSTART */
+uint16_t EVE_report_dl_estimate(void)
+{
+	return dl_estimate;
+}
+
+
+/* estimated number of bytes that are left in RAM_DL */
+uint16_t EVE_dl_budget_left(void)
+{
+	if(dl_estimate >= EVE_RAM_DL_SIZE)
+	{
+		return 0;
+	}
+
+	return (uint16_t) (EVE_RAM_DL_SIZE - dl_estimate);
+}
+
+
+/* returns 1 once the estimate got closer to the end of RAM_DL than EVE_DL_BUDGET_RESERVE bytes */
+uint8_t EVE_dl_budget_warning(void)
+{
+	if(dl_estimate > (EVE_RAM_DL_SIZE - EVE_DL_BUDGET_RESERVE))
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+#endif
+
+
 /* generic function for all commands that have no arguments and all display-list specific control words */
 /*
  examples:
@@ -1217,11 +1732,21 @@ void EVE_start_cmd(uint32_t command)
 */
 void EVE_cmd_dl(uint32_t command)
 {
-	EVE_start_cmd(command);
-	if(cmd_burst == 0)
+	if(command == CMD_COLDSTART)
 	{
-		EVE_cs_clear();
+		copro_fgcolor = 0x003870UL;
+		copro_bgcolor = 0x002040UL;
+		copro_gradcolor = 0xffffffUL;
+	}
+
+	#if defined (EVE_DL_OPTIMIZE)
+	if(EVE_dl_optimize(command) == 0)
+	{
+		return;
 	}
+	#endif
+
+	EVE_dl_write(command);
 }
 
 
@@ -1245,6 +1770,10 @@ void EVE_write_string(const char *text)
 	}
 
 	/* we need to transmit at least one 0x00 byte and up to four if the string happens to be 4-byte aligned already */
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add((uint32_t) dl_cost_per_char * textindex);
+	#endif
+
 	padding = textindex & 3;  /* 0, 1, 2 or 3 */
 	padding = 4-padding; /* 4, 3, 2 or 1 */
 	textindex += padding;
@@ -1645,6 +2174,7 @@ void EVE_cmd_clock(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_
 
 void EVE_cmd_bgcolor(uint32_t color)
 {
+	copro_bgcolor = color;
 	EVE_start_cmd(CMD_BGCOLOR);
 
 	if(cmd_burst)
@@ -1669,6 +2199,7 @@ void EVE_cmd_bgcolor(uint32_t color)
 
 void EVE_cmd_fgcolor(uint32_t color)
 {
+	copro_fgcolor = color;
 	EVE_start_cmd(CMD_FGCOLOR);
 
 	if(cmd_burst)
@@ -1693,6 +2224,7 @@ void EVE_cmd_fgcolor(uint32_t color)
 
 void EVE_cmd_gradcolor(uint32_t color)
 {
+	copro_gradcolor = color;
 	EVE_start_cmd(CMD_GRADCOLOR);
 
 	if(cmd_burst)
@@ -1715,6 +2247,15 @@ void EVE_cmd_gradcolor(uint32_t color)
 }
 
 
+/* last colors that were send with EVE_cmd_fgcolor(), EVE_cmd_bgcolor() and EVE_cmd_gradcolor() */
+void EVE_report_copro_colors(uint32_t *fgcolor, uint32_t *bgcolor, uint32_t *gradcolor)
+{
+	*fgcolor = copro_fgcolor;
+	*bgcolor = copro_bgcolor;
+	*gradcolor = copro_gradcolor;
+}
+
+
 void EVE_cmd_gauge(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t major, uint16_t minor, uint16_t val, uint16_t range)
 {
 	EVE_start_cmd(CMD_GAUGE);
@@ -2319,6 +2860,10 @@ void EVE_cmd_append(uint32_t ptr, uint32_t num)
 {
 	EVE_start_cmd(CMD_APPEND);
 
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add(num);
+	#endif
+
 	if(cmd_burst)
 	{
 		spi_transmit_async((uint8_t)(ptr));
@@ -3046,6 +3591,10 @@ void EVE_cmd_appendf(uint32_t ptr, uint32_t num)
 {
 	EVE_start_cmd(CMD_APPENDF);
 
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add(num);
+	#endif
+
 	if(cmd_burst)
 	{
 		spi_transmit_async((uint8_t)(ptr));
@@ -3080,10 +3629,174 @@ void EVE_cmd_appendf(uint32_t ptr, uint32_t num)
 #endif
 
 
+/* vertex encoding */
+/* VERTEX2II takes pixel coordinates from 0 to 511 directly, VERTEX2F has 15 bits signed for each coordinate in units given with VERTEX_FORMAT,
+	from 1 pixel with VERTEX_FORMAT(0) to 1/16 pixel with VERTEX_FORMAT(4), the reset-default.
+	The current VERTEX_FORMAT is followed thru everything that is send with EVE_start_cmd(), CMD_APPEND and friends make it unknown.
+	The co-processor widgets do not change it.
+	VERTEX2II is not used with BITMAPS since it also selects the bitmap-handle and the cell. */
+
+#define EVE_VERTEX_FORMAT_UNKNOWN 0xFF
+
+static uint8_t vertex_format = 4;
+static uint8_t vertex_use_2ii = 0; /* 1 while a BEGIN for something else than BITMAPS is active */
+
+
+/* called by EVE_start_cmd() for every command */
+static void EVE_vertex_state(uint32_t command)
+{
+	switch(command)
+	{
+		case CMD_DLSTART:
+			vertex_format = 4;
+			vertex_use_2ii = 0;
+			return;
+
+		case CMD_APPEND:
+		#if defined (BT81X_ENABLE)
+		case CMD_APPENDF:
+		#endif
+			vertex_format = EVE_VERTEX_FORMAT_UNKNOWN;
+			vertex_use_2ii = 0;
+			return;
+
+		default:
+			break;
+	}
+
+	switch(command >> 24)
+	{
+		case (DL_BEGIN >> 24):
+			vertex_use_2ii = ((command & 15UL) != EVE_BITMAPS);
+			break;
+
+		case (DL_END >> 24):
+			vertex_use_2ii = 0;
+			break;
+
+		#if defined (FT81X_ENABLE)
+		case (DL_VERTEX_FORMAT >> 24):
+			vertex_format = command & 7UL;
+			break;
+		#endif
+
+		case (DL_RESTORE_CONTEXT >> 24):
+		case (DL_CALL >> 24):
+		case (DL_JUMP >> 24):
+		case (DL_MACRO >> 24):
+			vertex_format = EVE_VERTEX_FORMAT_UNKNOWN;
+			vertex_use_2ii = 0;
+			break;
+
+		case 0xFF: /* co-processor widgets leave some primitive active */
+			vertex_use_2ii = 0;
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+/* VERTEX_FORMAT to use for VERTEX2F words that are calculated without checking it, the reset-default if it is unknown */
+uint8_t EVE_vertex_format_current(void)
+{
+	if(vertex_format == EVE_VERTEX_FORMAT_UNKNOWN)
+	{
+		return 4;
+	}
+	return vertex_format;
+}
+
+
+#if defined (FT81X_ENABLE)
+/* check if a coordinate in 1/16 pixel fits into VERTEX2F with the given format without loosing precision */
+static uint8_t EVE_vertex_fits(int32_t value, uint8_t format)
+{
+	int32_t unit;
+
+	unit = 1L << (4 - format);
+
+	if((value % unit) != 0)
+	{
+		return 0;
+	}
+
+	value /= unit;
+
+	if((value < -16384L) || (value > 16383L))
+	{
+		return 0;
+	}
+
+	return 1;
+}
+#endif
+
+
+/* vertex for the meta-commands, pixel coordinates and the primitive is known to not be BITMAPS */
+/* does not change VERTEX_FORMAT so that VERTEX2F words the application writes itself still work */
+uint32_t EVE_vertex_pixel(int16_t x0, int16_t y0)
+{
+	uint8_t format;
+
+	if((x0 >= 0) && (x0 < 512) && (y0 >= 0) && (y0 < 512))
+	{
+		return VERTEX2II(x0, y0, 0, 0);
+	}
+
+	format = EVE_vertex_format_current();
+	return VERTEX2F(((uint32_t) x0) << format, ((uint32_t) y0) << format);
+}
+
+
+/* write a vertex with coordinates in 1/16 pixel, using the least amount of display-list commands */
+/* VERTEX2II if the coordinates are whole pixels from 0 to 511, otherwise VERTEX2F with the current VERTEX_FORMAT if it is precise enough */
+/* or the smallest VERTEX_FORMAT that is precise enough, since that has the biggest range for the following vertices */
+void EVE_cmd_vertex(int32_t x0, int32_t y0)
+{
+	uint8_t format;
+	int32_t unit;
+
+	if((vertex_use_2ii != 0) && (((x0 | y0) & 15L) == 0) && (x0 >= 0) && (x0 < (512L * 16L)) && (y0 >= 0) && (y0 < (512L * 16L)))
+	{
+		EVE_cmd_dl(VERTEX2II(x0 / 16, y0 / 16, 0, 0));
+		return;
+	}
+
+	#if defined (FT81X_ENABLE)
+	format = vertex_format;
+
+	if((format == EVE_VERTEX_FORMAT_UNKNOWN) || (EVE_vertex_fits(x0, format) == 0) || (EVE_vertex_fits(y0, format) == 0))
+	{
+		for(format = 0; format < 4; format++)
+		{
+			if(EVE_vertex_fits(x0, format) && EVE_vertex_fits(y0, format))
+			{
+				break;
+			}
+		}
+		EVE_cmd_dl(VERTEX_FORMAT(format)); /* this also updates vertex_format */
+	}
+	#else
+	format = 4;
+	#endif
+
+	unit = 1L << (4 - format);
+	EVE_cmd_dl(VERTEX2F(x0 / unit, y0 / unit));
+}
+
+
 /* meta-commands, sequences of several display-list entries condensed into simpler to use functions at the price of some overhead */
 
 void EVE_cmd_point(int16_t x0, int16_t y0, uint16_t size)
 {
+	#if defined (EVE_DL_OPTIMIZE)
+	EVE_cmd_dl(DL_BEGIN | EVE_POINTS);
+	EVE_cmd_dl(POINT_SIZE(size*16));
+	EVE_cmd_dl(EVE_vertex_pixel(x0, y0));
+	EVE_cmd_dl(DL_END);
+	#else
 	uint32_t calc;
 
 	EVE_start_cmd((DL_BEGIN | EVE_POINTS));
@@ -3096,7 +3809,7 @@ void EVE_cmd_point(int16_t x0, int16_t y0, uint16_t size)
 		spi_transmit_async((uint8_t)(calc >> 16));
 		spi_transmit_async((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x0 * 16, y0 * 16);
+		calc = EVE_vertex_pixel(x0, y0);
 		spi_transmit_async((uint8_t)(calc));
 		spi_transmit_async((uint8_t)(calc >> 8));
 		spi_transmit_async((uint8_t)(calc >> 16));
@@ -3115,7 +3828,7 @@ void EVE_cmd_point(int16_t x0, int16_t y0, uint16_t size)
 		spi_transmit((uint8_t)(calc >> 16));
 		spi_transmit((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x0 * 16, y0 * 16);
+		calc = EVE_vertex_pixel(x0, y0);
 		spi_transmit((uint8_t)(calc));
 		spi_transmit((uint8_t)(calc >> 8));
 		spi_transmit((uint8_t)(calc >> 16));
@@ -3129,12 +3842,24 @@ void EVE_cmd_point(int16_t x0, int16_t y0, uint16_t size)
 		EVE_cs_clear();
 	}
 
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add(12);
+	#endif
+
 	EVE_inc_cmdoffset(12);
+	#endif
 }
 
 
 void EVE_cmd_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t width)
 {
+	#if defined (EVE_DL_OPTIMIZE)
+	EVE_cmd_dl(DL_BEGIN | EVE_LINES);
+	EVE_cmd_dl(LINE_WIDTH(width * 16));
+	EVE_cmd_dl(EVE_vertex_pixel(x0, y0));
+	EVE_cmd_dl(EVE_vertex_pixel(x1, y1));
+	EVE_cmd_dl(DL_END);
+	#else
 	uint32_t calc;
 
 	EVE_start_cmd((DL_BEGIN | EVE_LINES));
@@ -3147,13 +3872,13 @@ void EVE_cmd_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t width
 		spi_transmit_async((uint8_t)(calc >> 16));
 		spi_transmit_async((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x0 * 16, y0 * 16);
+		calc = EVE_vertex_pixel(x0, y0);
 		spi_transmit_async((uint8_t)(calc));
 		spi_transmit_async((uint8_t)(calc >> 8));
 		spi_transmit_async((uint8_t)(calc >> 16));
 		spi_transmit_async((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x1 * 16, y1 * 16);
+		calc = EVE_vertex_pixel(x1, y1);
 		spi_transmit_async((uint8_t)(calc));
 		spi_transmit_async((uint8_t)(calc >> 8));
 		spi_transmit_async((uint8_t)(calc >> 16));
@@ -3172,13 +3897,13 @@ void EVE_cmd_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t width
 		spi_transmit((uint8_t)(calc >> 16));
 		spi_transmit((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x0 * 16, y0 * 16);
+		calc = EVE_vertex_pixel(x0, y0);
 		spi_transmit((uint8_t)(calc));
 		spi_transmit((uint8_t)(calc >> 8));
 		spi_transmit((uint8_t)(calc >> 16));
 		spi_transmit((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x1 * 16, y1 * 16);
+		calc = EVE_vertex_pixel(x1, y1);
 		spi_transmit((uint8_t)(calc));
 		spi_transmit((uint8_t)(calc >> 8));
 		spi_transmit((uint8_t)(calc >> 16));
@@ -3192,12 +3917,24 @@ void EVE_cmd_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t width
 		EVE_cs_clear();
 	}
 
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add(16);
+	#endif
+
 	EVE_inc_cmdoffset(16);
+	#endif
 }
 
 
 void EVE_cmd_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t corner)
 {
+	#if defined (EVE_DL_OPTIMIZE)
+	EVE_cmd_dl(DL_BEGIN | EVE_RECTS);
+	EVE_cmd_dl(LINE_WIDTH(corner * 16));
+	EVE_cmd_dl(EVE_vertex_pixel(x0, y0));
+	EVE_cmd_dl(EVE_vertex_pixel(x1, y1));
+	EVE_cmd_dl(DL_END);
+	#else
 	uint32_t calc;
 
 	EVE_start_cmd((DL_BEGIN | EVE_RECTS));
@@ -3210,13 +3947,13 @@ void EVE_cmd_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t corne
 		spi_transmit_async((uint8_t)(calc >> 16));
 		spi_transmit_async((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x0 * 16, y0 * 16);
+		calc = EVE_vertex_pixel(x0, y0);
 		spi_transmit_async((uint8_t)(calc));
 		spi_transmit_async((uint8_t)(calc >> 8));
 		spi_transmit_async((uint8_t)(calc >> 16));
 		spi_transmit_async((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x1 * 16, y1 * 16);
+		calc = EVE_vertex_pixel(x1, y1);
 		spi_transmit_async((uint8_t)(calc));
 		spi_transmit_async((uint8_t)(calc >> 8));
 		spi_transmit_async((uint8_t)(calc >> 16));
@@ -3235,13 +3972,13 @@ void EVE_cmd_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t corne
 		spi_transmit((uint8_t)(calc >> 16));
 		spi_transmit((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x0 * 16, y0 * 16);
+		calc = EVE_vertex_pixel(x0, y0);
 		spi_transmit((uint8_t)(calc));
 		spi_transmit((uint8_t)(calc >> 8));
 		spi_transmit((uint8_t)(calc >> 16));
 		spi_transmit((uint8_t)(calc >> 24));
 
-		calc = VERTEX2F(x1 * 16, y1 * 16);
+		calc = EVE_vertex_pixel(x1, y1);
 		spi_transmit((uint8_t)(calc));
 		spi_transmit((uint8_t)(calc >> 8));
 		spi_transmit((uint8_t)(calc >> 16));
@@ -3255,5 +3992,303 @@ void EVE_cmd_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t corne
 		EVE_cs_clear();
 	}
 
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add(16);
+	#endif
+
 	EVE_inc_cmdoffset(16);
+	#endif
+}
+
+
+/* batch meta-commands, these draw a whole array of primitives with a single BEGIN / END and only change the size when it differs */
+/* note: the command-fifo is only 4k, the data for one batch has to fit into the free space of it, in burst-mode into the whole burst */
+
+#define EVE_BATCH_CHUNK 16 /* number of vertices that are packed on the stack before these are transmitted */
+
+
+/* pack "count" pixel coordinate pairs into VERTEX2F words for the given VERTEX_FORMAT, 4 is the reset-default of 1/16 pixel */
+/* this is just a loop without any branches over separate x and y arrays, this lets a compiler use SIMD instructions for it */
+void EVE_vertex2f_pack(uint32_t *dest, const int16_t *x, const int16_t *y, uint16_t count, uint8_t format)
+{
+	uint16_t index;
+
+	for(index = 0; index < count; index++)
+	{
+		dest[index] = (1UL<<30) | (((((uint32_t) x[index]) << format) & 32767UL) << 15) | ((((uint32_t) y[index]) << format) & 32767UL);
+	}
+}
+
+
+/* the same as EVE_vertex2f_pack() but with VERTEX2II for the vertices from 0 to 511, these do not depend on VERTEX_FORMAT */
+/* only for primitives other than BITMAPS, the handle and the cell are 0 */
+static void EVE_vertex_pack(uint32_t *dest, const int16_t *x, const int16_t *y, uint16_t count, uint8_t format)
+{
+	uint16_t index;
+
+	EVE_vertex2f_pack(dest, x, y, count, format);
+
+	for(index = 0; index < count; index++)
+	{
+		if((((uint16_t) x[index]) < 512U) && (((uint16_t) y[index]) < 512U))
+		{
+			dest[index] = VERTEX2II(x[index], y[index], 0, 0);
+		}
+	}
+}
+
+
+/* send a block of already packed vertices, VERTEX2F or VERTEX2II, without any further overhead */
+void EVE_cmd_vertices(const uint32_t *vertices, uint16_t count)
+{
+	uint32_t ftAddress;
+	uint16_t index;
+	uint32_t calc;
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	#if defined (EVE_DL_OPTIMIZE)
+	EVE_dl_flush_end();
+	#endif
+
+	if(cmd_burst)
+	{
+		for(index = 0; index < count; index++)
+		{
+			calc = vertices[index];
+			spi_transmit_async((uint8_t)(calc));
+			spi_transmit_async((uint8_t)(calc >> 8));
+			spi_transmit_async((uint8_t)(calc >> 16));
+			spi_transmit_async((uint8_t)(calc >> 24));
+		}
+	}
+	else
+	{
+		ftAddress = EVE_RAM_CMD + cmdOffset;
+		EVE_cs_set();
+		spi_transmit((uint8_t)(ftAddress >> 16) | MEM_WRITE); /* send Memory Write plus high address byte */
+		spi_transmit((uint8_t)(ftAddress >> 8));	/* send middle address byte */
+		spi_transmit((uint8_t)(ftAddress));		/* send low address byte */
+
+		for(index = 0; index < count; index++)
+		{
+			calc = vertices[index];
+			spi_transmit((uint8_t)(calc));
+			spi_transmit((uint8_t)(calc >> 8));
+			spi_transmit((uint8_t)(calc >> 16));
+			spi_transmit((uint8_t)(calc >> 24));
+		}
+
+		EVE_cs_clear();
+	}
+
+	#if defined (EVE_DL_BUDGET)
+	EVE_dl_budget_add((uint32_t) count * 4);
+	#endif
+
+	EVE_inc_cmdoffset(count * 4);
+}
+
+
+void EVE_cmd_points(const EVE_point_t *points, uint16_t count)
+{
+	int16_t x[EVE_BATCH_CHUNK];
+	int16_t y[EVE_BATCH_CHUNK];
+	uint32_t vertices[EVE_BATCH_CHUNK];
+	uint16_t index;
+	uint8_t fill = 0;
+	uint16_t size = 0;
+	uint8_t format;
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	format = EVE_vertex_format_current();
+
+	EVE_cmd_dl(DL_BEGIN | EVE_POINTS);
+
+	for(index = 0; index < count; index++)
+	{
+		if((index == 0) || (points[index].size != size))
+		{
+			if(fill != 0)
+			{
+				EVE_vertex_pack(vertices, x, y, fill, format);
+				EVE_cmd_vertices(vertices, fill);
+				fill = 0;
+			}
+
+			size = points[index].size;
+			EVE_cmd_dl(POINT_SIZE(size * 16));
+		}
+
+		x[fill] = points[index].x0;
+		y[fill] = points[index].y0;
+		fill++;
+
+		if(fill == EVE_BATCH_CHUNK)
+		{
+			EVE_vertex_pack(vertices, x, y, fill, format);
+			EVE_cmd_vertices(vertices, fill);
+			fill = 0;
+		}
+	}
+
+	if(fill != 0)
+	{
+		EVE_vertex_pack(vertices, x, y, fill, format);
+		EVE_cmd_vertices(vertices, fill);
+	}
+
+	EVE_cmd_dl(DL_END);
+}
+
+
+/* lines and rectangles only differ in the primitive, both use LINE_WIDTH and two vertices each */
+static void EVE_cmd_linerects(uint32_t primitive, const EVE_line_t *lines, uint16_t count)
+{
+	int16_t x[EVE_BATCH_CHUNK];
+	int16_t y[EVE_BATCH_CHUNK];
+	uint32_t vertices[EVE_BATCH_CHUNK];
+	uint16_t index;
+	uint8_t fill = 0;
+	uint16_t width = 0;
+	uint8_t format;
+
+	if(count == 0)
+	{
+		return;
+	}
+
+	format = EVE_vertex_format_current();
+
+	EVE_cmd_dl(DL_BEGIN | primitive);
+
+	for(index = 0; index < count; index++)
+	{
+		if((index == 0) || (lines[index].width != width))
+		{
+			if(fill != 0)
+			{
+				EVE_vertex_pack(vertices, x, y, fill, format);
+				EVE_cmd_vertices(vertices, fill);
+				fill = 0;
+			}
+
+			width = lines[index].width;
+			EVE_cmd_dl(LINE_WIDTH(width * 16));
+		}
+
+		x[fill] = lines[index].x0;
+		y[fill] = lines[index].y0;
+		fill++;
+		x[fill] = lines[index].x1;
+		y[fill] = lines[index].y1;
+		fill++;
+
+		if(fill == EVE_BATCH_CHUNK)
+		{
+			EVE_vertex_pack(vertices, x, y, fill, format);
+			EVE_cmd_vertices(vertices, fill);
+			fill = 0;
+		}
+	}
+
+	if(fill != 0)
+	{
+		EVE_vertex_pack(vertices, x, y, fill, format);
+		EVE_cmd_vertices(vertices, fill);
+	}
+
+	EVE_cmd_dl(DL_END);
+}
+
+
+void EVE_cmd_lines(const EVE_line_t *lines, uint16_t count)
+{
+	EVE_cmd_linerects(EVE_LINES, lines, count);
+}
+
+
+/* width is the corner-radius for rectangles */
+void EVE_cmd_rects(const EVE_line_t *rects, uint16_t count)
+{
+	EVE_cmd_linerects(EVE_RECTS, rects, count);
+}
+
+
+/*
+macro bindings
+The display-list command MACRO(0) / MACRO(1) is replaced by the graphics engine with the value of REG_MACRO_0 / REG_MACRO_1
+while the list is rendered, so a single register write changes a list that is on screen without building a new one.
+A binding reserves one of the two registers for a value that changes fast, the value is a complete display-list command:
+
+needle = EVE_macro_bind(VERTEX2F(x1 * 16, y1 * 16));
+...
+EVE_cmd_dl(DL_BEGIN | EVE_LINES);
+EVE_cmd_dl(VERTEX2F(x0 * 16, y0 * 16));
+EVE_cmd_macro(needle);
+EVE_cmd_dl(DL_END);
+...
+EVE_macro_set(needle, VERTEX2F(x1 * 16, y1 * 16)); // from then on, no new list required
+
+The new value is picked up with the next line the graphics engine renders, so to avoid tearing update it right after REG_FRAMES changed.
+*/
+
+static uint8_t macro_used = 0; /* bit 0 for REG_MACRO_0, bit 1 for REG_MACRO_1 */
+static uint32_t macro_value[2];
+
+
+/* reserve a macro register and set it to value, returns the slot 0 or 1 or EVE_MACRO_NONE if both are in use */
+uint8_t EVE_macro_bind(uint32_t value)
+{
+	uint8_t slot;
+
+	for(slot = 0; slot < 2; slot++)
+	{
+		if((macro_used & (1 << slot)) == 0)
+		{
+			macro_used |= (1 << slot);
+			macro_value[slot] = ~value;
+			EVE_macro_set(slot, value);
+			return slot;
+		}
+	}
+
+	return EVE_MACRO_NONE;
+}
+
+
+void EVE_macro_release(uint8_t slot)
+{
+	if(slot < 2)
+	{
+		macro_used &= ~(1 << slot);
+	}
+}
+
+
+/* a single 32 bit register write, only when the value really changed, this is meant to be called outside display-list building */
+void EVE_macro_set(uint8_t slot, uint32_t value)
+{
+	if((slot < 2) && (macro_value[slot] != value))
+	{
+		macro_value[slot] = value;
+		EVE_memWrite32((slot == 0) ? REG_MACRO_0 : REG_MACRO_1, value);
+	}
+}
+
+
+/* put the place-holder for the bound value into the display-list */
+void EVE_cmd_macro(uint8_t slot)
+{
+	if(slot < 2)
+	{
+		EVE_cmd_dl(MACRO(slot));
+	}
 }
@@ -1,8 +1,8 @@
 /*
 @file    EVE_commands.h
 @brief   contains FT8xx / BT8xx function prototypes
-@version 4.0
-@date    2019-04-07
+@version 4.1
+@date    2026-10-19
 @author  Rudolph Riedel
 
 @section History
@@ -65,6 +65,17 @@
 	EVE_cmd_animdraw(), EVE_cmd_animframe(), EVE_cmd_gradienta(), EVE_cmd_fillwidth() and EVE_cmd_appendf()
 - added a paramter to EVE_get_touch_tag() to allow multi-touch
 
+4.1
+- added prototype for EVE_report_dl_saved()
+- added EVE_point_t and EVE_line_t plus prototypes for EVE_cmd_points(), EVE_cmd_lines(), EVE_cmd_rects(), EVE_cmd_vertices() and EVE_vertex2f_pack()
+- added prototypes for EVE_cmd_vertex(), EVE_vertex_pixel() and EVE_vertex_format_current()
+- added prototypes for EVE_dl_cost(), EVE_report_dl_estimate(), EVE_dl_budget_left() and EVE_dl_budget_warning()
+- added prototype for EVE_report_copro_colors()
+- added prototypes for EVE_memWrite_sram_buffer(), EVE_start_cmd_stage() and EVE_end_cmd_stage()
+- added EVE_MACRO_NONE and prototypes for EVE_macro_bind(), EVE_macro_release(), EVE_macro_set() and EVE_cmd_macro()
+- added prototype for EVE_cmd_videoframe()
+- added prototype for block_transfer() to stream data for a command from elsewhere
+
 */
 
 #ifndef EVE_COMMANDS_H_
@@ -80,6 +91,7 @@ void EVE_memWrite8(uint32_t ftAddress, uint8_t ftData8);
 void EVE_memWrite16(uint32_t ftAddress, uint16_t ftData16);
 void EVE_memWrite32(uint32_t ftAddress, uint32_t ftData32);
 void EVE_memWrite_flash_buffer(uint32_t ftAddress, const uint8_t *data, uint16_t len);
+void EVE_memWrite_sram_buffer(uint32_t ftAddress, const uint8_t *data, uint16_t len);
 uint8_t EVE_busy(void);
 void EVE_get_cmdoffset(void);
 uint16_t EVE_report_cmdoffset(void);
@@ -99,17 +111,35 @@ void EVE_cmd_loadimage(uint32_t ptr, uint32_t options, const uint8_t *data, uint
 
 #if defined (FT81X_ENABLE)
 void EVE_cmd_mediafifo(uint32_t ptr, uint32_t size);
+void EVE_cmd_videoframe(uint32_t dest, uint32_t ptr);
 #endif
 
 
 void EVE_cmd_start(void);
 void EVE_cmd_execute(void);
+void block_transfer(const uint8_t *data, uint16_t len);
 
 void EVE_start_cmd_burst(void);
 void EVE_end_cmd_burst(void);
 
+#if defined (EVE_PIPELINE)
+void EVE_start_cmd_stage(uint8_t *buffer);
+uint16_t EVE_end_cmd_stage(void);
+#endif
+
 void EVE_cmd_dl(uint32_t command);
 
+#if defined (EVE_DL_OPTIMIZE)
+uint16_t EVE_report_dl_saved(void);
+#endif
+
+#if defined (EVE_DL_BUDGET)
+uint16_t EVE_dl_cost(uint32_t command, uint16_t chars);
+uint16_t EVE_report_dl_estimate(void);
+uint16_t EVE_dl_budget_left(void);
+uint8_t EVE_dl_budget_warning(void);
+#endif
+
 
 /* EVE3 commands */
 #if defined (BT81X_ENABLE)
@@ -144,6 +174,7 @@ void EVE_cmd_clock(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_
 void EVE_cmd_bgcolor(uint32_t color);
 void EVE_cmd_fgcolor(uint32_t color);
 void EVE_cmd_gradcolor(uint32_t color);
+void EVE_report_copro_colors(uint32_t *fgcolor, uint32_t *bgcolor, uint32_t *gradcolor);
 void EVE_cmd_gauge(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t major, uint16_t minor, uint16_t val, uint16_t range);
 void EVE_cmd_gradient(int16_t x0, int16_t y0, uint32_t rgb0, int16_t x1, int16_t y1, uint32_t rgb1);
 void EVE_cmd_keys(int16_t x0, int16_t y0, int16_t w0, int16_t h0, int16_t font, uint16_t options, const char* text);
@@ -196,12 +227,51 @@ uint16_t EVE_cmd_regread(uint32_t ptr);
 uint16_t EVE_cmd_getprops(uint32_t ptr);
 
 
+/* vertex encoding, coordinates for EVE_cmd_vertex() are in 1/16 pixel */
+void EVE_cmd_vertex(int32_t x0, int32_t y0);
+uint32_t EVE_vertex_pixel(int16_t x0, int16_t y0);
+uint8_t EVE_vertex_format_current(void);
+
+
 /* meta-commands, sequences of several display-list entries condensed into simpler to use functions at the price of some overhead */
 void EVE_cmd_point(int16_t x0, int16_t y0, uint16_t size);
 void EVE_cmd_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t w0);
 void EVE_cmd_rect(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t corner);
 
 
+/* batch meta-commands, one BEGIN / END for the whole array and a size-change only when it differs from the previous entry */
+typedef struct
+{
+	int16_t x0;
+	int16_t y0;
+	uint16_t size;
+} EVE_point_t;
+
+typedef struct
+{
+	int16_t x0;
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+	uint16_t width; /* line-width or corner-radius */
+} EVE_line_t;
+
+void EVE_vertex2f_pack(uint32_t *dest, const int16_t *x, const int16_t *y, uint16_t count, uint8_t format);
+void EVE_cmd_vertices(const uint32_t *vertices, uint16_t count);
+void EVE_cmd_points(const EVE_point_t *points, uint16_t count);
+void EVE_cmd_lines(const EVE_line_t *lines, uint16_t count);
+void EVE_cmd_rects(const EVE_line_t *rects, uint16_t count);
+
+
+/* macro bindings, values that change without building a new display-list */
+#define EVE_MACRO_NONE 0xFF
+
+uint8_t EVE_macro_bind(uint32_t value);
+void EVE_macro_release(uint8_t slot);
+void EVE_macro_set(uint8_t slot, uint32_t value);
+void EVE_cmd_macro(uint8_t slot);
+
+
 /* startup FT8xx: */
 uint8_t EVE_init(void);
 
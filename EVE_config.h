@@ -99,6 +99,11 @@
 - added a block for the SAME51J18A
 - added profiles for the BT81x 4.3", 5" and 7" modules from Riverdi - the only tested is the 4.3" with a RVT43ULBNWC00
 
+4.1
+- added a block for optional library features, starting with EVE_DL_OPTIMIZE
+- added EVE_DL_BUDGET and EVE_DL_BUDGET_RESERVE
+- added EVE_PIPELINE and EVE_PIPE_BUFFER
+
 */
 
 #ifndef EVE_CONFIG_H_
@@ -146,6 +151,23 @@
 #define EVE_RiTFT43
 
 
+/* optional library features, un-comment to enable */
+
+/* EVE_DL_OPTIMIZE: EVE_cmd_dl() keeps track of the graphics-state and drops display-list commands that would not change anything, */
+/* like a second COLOR_RGB with the same value, this also allows EVE_cmd_point(), EVE_cmd_line() and EVE_cmd_rect() to share BEGIN/END */
+//#define EVE_DL_OPTIMIZE
+
+/* EVE_DL_BUDGET: the size the co-processor will expand the current display-list to is estimated while it is build, */
+/* EVE_dl_budget_warning() returns 1 once less than EVE_DL_BUDGET_RESERVE bytes are left in RAM_DL */
+//#define EVE_DL_BUDGET
+#define EVE_DL_BUDGET_RESERVE 512
+
+/* EVE_PIPELINE: frames can be encoded into buffers in RAM while the co-processor still works on the previous one, see EVE_pipeline.c */
+/* EVE_PIPE_BUFFER is the size of one buffer, the command-fifo only has 4k so more than 4092 bytes can not be written in one go */
+//#define EVE_PIPELINE
+#define EVE_PIPE_BUFFER 4092
+
+
 /* While the following lines make things a lot easier like automatically compiling the code for the platform you are compiling for, */
 /* a few things are expected to be taken care of beforehand. */
 /* - setting the Chip-Select and Power-Down pins to Output, Chip-Select = 1 and Power-Down = 0 */
@@ -0,0 +1,765 @@
+/*
+@file    EVE_convert.c
+@brief   conversion of RGB888 / RGBA8888 pixels to RGB565, ARGB1555, ARGB4, L8 and L4, with scalar, SSE2, AVX2 and NEON kernels
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+For bitmaps that are generated at runtime, like camera frames or screenshots.
+The kernels are selected when compiling, AVX2 or SSE2 are used on x86 when the compiler is told to use them
+(-mavx2, -msse2 is the default for x86-64) and NEON is used when __ARM_NEON is defined.
+SSE2 and AVX2 convert RGBA8888, NEON converts RGB888 and RGBA8888, L4 and everything else use the scalar kernels.
+The pixels are truncated to the bits of the format, all kernels give exactly the same result.
+
+The dithering is always scalar, EVE_DITHER_ORDERED adds a 4x4 Bayer matrix and EVE_DITHER_DIFFUSION does
+Floyd-Steinberg error diffusion which needs a buffer for the errors of the next line.
+L8 has all the bits there are, it is never dithered.
+
+static int16_t errors[EVE_CONVERT_ERRORS(320)];
+EVE_convert_t conv;
+
+EVE_convert_init(&conv, EVE_RGB565, EVE_CONVERT_RGB888, 320, EVE_DITHER_DIFFUSION, errors);
+EVE_convert_upload(&conv, MEM_CAMERA, frame, 240, 320 * 3);
+EVE_convert_restart(&conv);	for the next frame
+
+EVE_convert_upload() converts the lines directly into EVE_dma_buffer behind the address and starts the DMA
+when EVE_DMA is enabled, otherwise into a buffer of EVE_CONVERT_BUFFER bytes which is written with EVE_memWrite_sram_buffer().
+It is meant to be called outside display-list building, does not support cmd-burst.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_target.h"
+#include "EVE_convert.h"
+
+#if defined (__SSE2__) || defined (__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+
+#define MEM_WRITE	0x80	/* EVE Host Memory Write */
+
+static const uint8_t EVE_bayer4[16] =
+{
+	0, 8, 2, 10,
+	12, 4, 14, 6,
+	3, 11, 1, 9,
+	15, 7, 13, 5
+};
+
+
+static inline uint16_t EVE_pack_rgb565(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+	(void) a;
+	return (uint16_t) (((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+
+static inline uint16_t EVE_pack_argb1555(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+	return (uint16_t) (((a >> 7) << 15) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3));
+}
+
+
+static inline uint16_t EVE_pack_argb4(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+	return (uint16_t) (((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4));
+}
+
+
+static inline uint8_t EVE_luminance(uint32_t r, uint32_t g, uint32_t b)
+{
+	return (uint8_t) (((r * 77U) + (g * 150U) + (b * 29U)) >> 8);
+}
+
+
+/* scalar kernels, for RGB888 (_3) and RGBA8888 (_4) */
+
+#define EVE_KERNEL_16(name, pack) \
+static void name##_3(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	uint16_t value; \
+	for(; count != 0; count--) \
+	{ \
+		value = pack(src[0], src[1], src[2], 0xFF); \
+		dst[0] = (uint8_t) value; \
+		dst[1] = (uint8_t) (value >> 8); \
+		dst += 2; \
+		src += 3; \
+	} \
+} \
+static void name##_4(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	uint16_t value; \
+	for(; count != 0; count--) \
+	{ \
+		value = pack(src[0], src[1], src[2], src[3]); \
+		dst[0] = (uint8_t) value; \
+		dst[1] = (uint8_t) (value >> 8); \
+		dst += 2; \
+		src += 4; \
+	} \
+}
+
+EVE_KERNEL_16(EVE_rgb565, EVE_pack_rgb565)
+EVE_KERNEL_16(EVE_argb1555, EVE_pack_argb1555)
+EVE_KERNEL_16(EVE_argb4, EVE_pack_argb4)
+
+#define EVE_KERNEL_L(bpp) \
+static void EVE_l8_##bpp(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	for(; count != 0; count--) \
+	{ \
+		*dst++ = EVE_luminance(src[0], src[1], src[2]); \
+		src += bpp; \
+	} \
+} \
+static void EVE_l4_##bpp(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	for(; count > 1; count -= 2) \
+	{ \
+		*dst++ = (uint8_t) ((EVE_luminance(src[0], src[1], src[2]) & 0xF0) | (EVE_luminance(src[bpp], src[bpp + 1], src[bpp + 2]) >> 4)); \
+		src += 2 * bpp; \
+	} \
+	if(count != 0) \
+	{ \
+		*dst = EVE_luminance(src[0], src[1], src[2]) & 0xF0; \
+	} \
+}
+
+EVE_KERNEL_L(3)
+EVE_KERNEL_L(4)
+
+
+#if defined (__SSE2__) && !defined (__AVX2__)
+/* 8 pixels RGBA8888 at a time, r is in bits 0-7 of each 32 bit lane, a in bits 24-31 */
+
+static inline __m128i EVE_sse2_rgb565(__m128i px)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(px, _mm_set1_epi32(0xF8)), 8),
+		_mm_srli_epi32(_mm_and_si128(px, _mm_set1_epi32(0xFC00)), 5)), _mm_and_si128(_mm_srli_epi32(px, 19), _mm_set1_epi32(0x1F)));
+}
+
+static inline __m128i EVE_sse2_argb1555(__m128i px)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(px, 16), _mm_set1_epi32(0x8000)), _mm_slli_epi32(_mm_and_si128(px, _mm_set1_epi32(0xF8)), 7)),
+		_mm_or_si128(_mm_srli_epi32(_mm_and_si128(px, _mm_set1_epi32(0xF800)), 6), _mm_and_si128(_mm_srli_epi32(px, 19), _mm_set1_epi32(0x1F))));
+}
+
+static inline __m128i EVE_sse2_argb4(__m128i px)
+{
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(px, 16), _mm_set1_epi32(0xF000)), _mm_slli_epi32(_mm_and_si128(px, _mm_set1_epi32(0xF0)), 4)),
+		_mm_or_si128(_mm_and_si128(_mm_srli_epi32(px, 8), _mm_set1_epi32(0xF0)), _mm_and_si128(_mm_srli_epi32(px, 20), _mm_set1_epi32(0x0F))));
+}
+
+/* the values are unsigned 16 bit, sign-extend them so that the saturation of _mm_packs_epi32() does not change them */
+static inline __m128i EVE_sse2_pack16(__m128i low, __m128i high)
+{
+	return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(low, 16), 16), _mm_srai_epi32(_mm_slli_epi32(high, 16), 16));
+}
+
+#define EVE_KERNEL_SSE2(name, convert) \
+static void name(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	__m128i low, high; \
+	for(; count >= 8; count -= 8) \
+	{ \
+		low = convert(_mm_loadu_si128((const __m128i *) src)); \
+		high = convert(_mm_loadu_si128((const __m128i *) (src + 16))); \
+		_mm_storeu_si128((__m128i *) dst, EVE_sse2_pack16(low, high)); \
+		dst += 16; \
+		src += 32; \
+	} \
+}
+
+EVE_KERNEL_SSE2(EVE_sse2_rgb565_8, EVE_sse2_rgb565)
+EVE_KERNEL_SSE2(EVE_sse2_argb1555_8, EVE_sse2_argb1555)
+EVE_KERNEL_SSE2(EVE_sse2_argb4_8, EVE_sse2_argb4)
+
+static inline __m128i EVE_sse2_l8(__m128i px)
+{
+	__m128i mask = _mm_set1_epi32(0xFF);
+	__m128i sum;
+
+	sum = _mm_mullo_epi16(_mm_and_si128(px, mask), _mm_set1_epi32(77));
+	sum = _mm_add_epi32(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(px, 8), mask), _mm_set1_epi32(150)));
+	sum = _mm_add_epi32(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi32(px, 16), mask), _mm_set1_epi32(29)));
+	return _mm_srli_epi32(sum, 8);
+}
+
+static void EVE_sse2_l8_16(uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	__m128i low, high;
+
+	for(; count >= 16; count -= 16)
+	{
+		low = _mm_packs_epi32(EVE_sse2_l8(_mm_loadu_si128((const __m128i *) src)), EVE_sse2_l8(_mm_loadu_si128((const __m128i *) (src + 16))));
+		high = _mm_packs_epi32(EVE_sse2_l8(_mm_loadu_si128((const __m128i *) (src + 32))), EVE_sse2_l8(_mm_loadu_si128((const __m128i *) (src + 48))));
+		_mm_storeu_si128((__m128i *) dst, _mm_packus_epi16(low, high));
+		dst += 16;
+		src += 64;
+	}
+}
+
+#define EVE_SIMD_STEP 8		/* pixels per iteration for the 16 bit formats */
+#define EVE_SIMD_STEP_L8 16
+#define EVE_SIMD_NAME "SSE2"
+#define EVE_simd_rgb565 EVE_sse2_rgb565_8
+#define EVE_simd_argb1555 EVE_sse2_argb1555_8
+#define EVE_simd_argb4 EVE_sse2_argb4_8
+#define EVE_simd_l8 EVE_sse2_l8_16
+#endif /* SSE2 */
+
+
+#if defined (__AVX2__)
+/* 16 pixels RGBA8888 at a time */
+
+static inline __m256i EVE_avx2_rgb565(__m256i px)
+{
+	return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(px, _mm256_set1_epi32(0xF8)), 8),
+		_mm256_srli_epi32(_mm256_and_si256(px, _mm256_set1_epi32(0xFC00)), 5)), _mm256_and_si256(_mm256_srli_epi32(px, 19), _mm256_set1_epi32(0x1F)));
+}
+
+static inline __m256i EVE_avx2_argb1555(__m256i px)
+{
+	return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(px, 16), _mm256_set1_epi32(0x8000)), _mm256_slli_epi32(_mm256_and_si256(px, _mm256_set1_epi32(0xF8)), 7)),
+		_mm256_or_si256(_mm256_srli_epi32(_mm256_and_si256(px, _mm256_set1_epi32(0xF800)), 6), _mm256_and_si256(_mm256_srli_epi32(px, 19), _mm256_set1_epi32(0x1F))));
+}
+
+static inline __m256i EVE_avx2_argb4(__m256i px)
+{
+	return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(px, 16), _mm256_set1_epi32(0xF000)), _mm256_slli_epi32(_mm256_and_si256(px, _mm256_set1_epi32(0xF0)), 4)),
+		_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(px, 8), _mm256_set1_epi32(0xF0)), _mm256_and_si256(_mm256_srli_epi32(px, 20), _mm256_set1_epi32(0x0F))));
+}
+
+/* _mm256_packus_epi32() packs within the 128 bit lanes, the permute puts the pixels back in order */
+static inline __m256i EVE_avx2_pack16(__m256i low, __m256i high)
+{
+	return _mm256_permute4x64_epi64(_mm256_packus_epi32(low, high), 0xD8);
+}
+
+#define EVE_KERNEL_AVX2(name, convert) \
+static void name(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	__m256i low, high; \
+	for(; count >= 16; count -= 16) \
+	{ \
+		low = convert(_mm256_loadu_si256((const __m256i *) src)); \
+		high = convert(_mm256_loadu_si256((const __m256i *) (src + 32))); \
+		_mm256_storeu_si256((__m256i *) dst, EVE_avx2_pack16(low, high)); \
+		dst += 32; \
+		src += 64; \
+	} \
+}
+
+EVE_KERNEL_AVX2(EVE_avx2_rgb565_16, EVE_avx2_rgb565)
+EVE_KERNEL_AVX2(EVE_avx2_argb1555_16, EVE_avx2_argb1555)
+EVE_KERNEL_AVX2(EVE_avx2_argb4_16, EVE_avx2_argb4)
+
+static inline __m256i EVE_avx2_l8(__m256i px)
+{
+	__m256i mask = _mm256_set1_epi32(0xFF);
+	__m256i sum;
+
+	sum = _mm256_mullo_epi16(_mm256_and_si256(px, mask), _mm256_set1_epi32(77));
+	sum = _mm256_add_epi32(sum, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(px, 8), mask), _mm256_set1_epi32(150)));
+	sum = _mm256_add_epi32(sum, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi32(px, 16), mask), _mm256_set1_epi32(29)));
+	return _mm256_srli_epi32(sum, 8);
+}
+
+static void EVE_avx2_l8_32(uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	__m256i low, high;
+
+	for(; count >= 32; count -= 32)
+	{
+		low = _mm256_packus_epi32(EVE_avx2_l8(_mm256_loadu_si256((const __m256i *) src)), EVE_avx2_l8(_mm256_loadu_si256((const __m256i *) (src + 32))));
+		high = _mm256_packus_epi32(EVE_avx2_l8(_mm256_loadu_si256((const __m256i *) (src + 64))), EVE_avx2_l8(_mm256_loadu_si256((const __m256i *) (src + 96))));
+		/* both packs work within the 128 bit lanes, the bytes end up as 0-3, 8-11, 16-19, 24-27, 4-7, 12-15, 20-23, 28-31 */
+		_mm256_storeu_si256((__m256i *) dst, _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+		dst += 32;
+		src += 128;
+	}
+}
+
+#define EVE_SIMD_STEP 16
+#define EVE_SIMD_STEP_L8 32
+#define EVE_SIMD_NAME "AVX2"
+#define EVE_simd_rgb565 EVE_avx2_rgb565_16
+#define EVE_simd_argb1555 EVE_avx2_argb1555_16
+#define EVE_simd_argb4 EVE_avx2_argb4_16
+#define EVE_simd_l8 EVE_avx2_l8_32
+#endif /* AVX2 */
+
+
+#if defined (EVE_SIMD_NAME)
+/* the SIMD kernels only do full steps, the rest of the line is done by the scalar kernel */
+
+static void EVE_x86_rgb565(uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	uint16_t done = count - (count % EVE_SIMD_STEP);
+
+	EVE_simd_rgb565(dst, src, done);
+	EVE_rgb565_4(dst + (done * 2), src + (done * 4), count - done);
+}
+
+static void EVE_x86_argb1555(uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	uint16_t done = count - (count % EVE_SIMD_STEP);
+
+	EVE_simd_argb1555(dst, src, done);
+	EVE_argb1555_4(dst + (done * 2), src + (done * 4), count - done);
+}
+
+static void EVE_x86_argb4(uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	uint16_t done = count - (count % EVE_SIMD_STEP);
+
+	EVE_simd_argb4(dst, src, done);
+	EVE_argb4_4(dst + (done * 2), src + (done * 4), count - done);
+}
+
+static void EVE_x86_l8(uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	uint16_t done = count - (count % EVE_SIMD_STEP_L8);
+
+	EVE_simd_l8(dst, src, done);
+	EVE_l8_4(dst + done, src + (done * 4), count - done);
+}
+#endif /* EVE_SIMD_NAME */
+
+
+#if defined (__ARM_NEON)
+/* 16 pixels at a time, vld3q_u8() / vld4q_u8() split the pixels into one register per channel */
+
+static inline uint16x8_t EVE_neon_pack(uint8_t format, uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+{
+	uint16x8_t value;
+
+	if(format == EVE_RGB565)
+	{
+		value = vsriq_n_u16(vshll_n_u8(r, 8), vshll_n_u8(g, 8), 5);
+		return vsriq_n_u16(value, vshll_n_u8(b, 8), 11);
+	}
+
+	if(format == EVE_ARGB1555)
+	{
+		value = vsriq_n_u16(vshll_n_u8(a, 8), vshll_n_u8(r, 8), 1);
+		value = vsriq_n_u16(value, vshll_n_u8(g, 8), 6);
+		return vsriq_n_u16(value, vshll_n_u8(b, 8), 11);
+	}
+
+	value = vsriq_n_u16(vshll_n_u8(a, 8), vshll_n_u8(r, 8), 4);
+	value = vsriq_n_u16(value, vshll_n_u8(g, 8), 8);
+	return vsriq_n_u16(value, vshll_n_u8(b, 8), 12);
+}
+
+static inline void EVE_neon_kernel(uint8_t format, uint8_t bpp, uint8_t *dst, const uint8_t *src, uint16_t count)
+{
+	uint8x16x3_t rgb;
+	uint8x16x4_t rgba;
+	uint16x8_t sum;
+	uint8x16_t r, g, b, a;
+
+	for(; count >= 16; count -= 16)
+	{
+		if(bpp == 3)
+		{
+			rgb = vld3q_u8(src);
+			r = rgb.val[0];
+			g = rgb.val[1];
+			b = rgb.val[2];
+			a = vdupq_n_u8(0xFF);
+		}
+		else
+		{
+			rgba = vld4q_u8(src);
+			r = rgba.val[0];
+			g = rgba.val[1];
+			b = rgba.val[2];
+			a = rgba.val[3];
+		}
+
+		if(format == EVE_L8)
+		{
+			sum = vmull_u8(vget_low_u8(r), vdup_n_u8(77));
+			sum = vmlal_u8(sum, vget_low_u8(g), vdup_n_u8(150));
+			sum = vmlal_u8(sum, vget_low_u8(b), vdup_n_u8(29));
+			vst1_u8(dst, vshrn_n_u16(sum, 8));
+			sum = vmull_u8(vget_high_u8(r), vdup_n_u8(77));
+			sum = vmlal_u8(sum, vget_high_u8(g), vdup_n_u8(150));
+			sum = vmlal_u8(sum, vget_high_u8(b), vdup_n_u8(29));
+			vst1_u8(dst + 8, vshrn_n_u16(sum, 8));
+			dst += 16;
+		}
+		else
+		{
+			vst1q_u8(dst, vreinterpretq_u8_u16(EVE_neon_pack(format, vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), vget_low_u8(a))));
+			vst1q_u8(dst + 16, vreinterpretq_u8_u16(EVE_neon_pack(format, vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), vget_high_u8(a))));
+			dst += 32;
+		}
+
+		src += 16 * bpp;
+	}
+}
+
+/* the rest of the line is done by the scalar kernel */
+#define EVE_KERNEL_NEON(name, format, bpp, scalar, size) \
+static void name(uint8_t *dst, const uint8_t *src, uint16_t count) \
+{ \
+	uint16_t done = count & ~15U; \
+	EVE_neon_kernel(format, bpp, dst, src, done); \
+	scalar(dst + (done * size), src + (done * bpp), count - done); \
+}
+
+EVE_KERNEL_NEON(EVE_neon_rgb565_3, EVE_RGB565, 3, EVE_rgb565_3, 2)
+EVE_KERNEL_NEON(EVE_neon_rgb565_4, EVE_RGB565, 4, EVE_rgb565_4, 2)
+EVE_KERNEL_NEON(EVE_neon_argb1555_3, EVE_ARGB1555, 3, EVE_argb1555_3, 2)
+EVE_KERNEL_NEON(EVE_neon_argb1555_4, EVE_ARGB1555, 4, EVE_argb1555_4, 2)
+EVE_KERNEL_NEON(EVE_neon_argb4_3, EVE_ARGB4, 3, EVE_argb4_3, 2)
+EVE_KERNEL_NEON(EVE_neon_argb4_4, EVE_ARGB4, 4, EVE_argb4_4, 2)
+EVE_KERNEL_NEON(EVE_neon_l8_3, EVE_L8, 3, EVE_l8_3, 1)
+EVE_KERNEL_NEON(EVE_neon_l8_4, EVE_L8, 4, EVE_l8_4, 1)
+#endif /* __ARM_NEON */
+
+
+static void EVE_convert_select(EVE_convert_t *conv)
+{
+	uint8_t rgba = (conv->source == EVE_CONVERT_RGBA8888);
+
+	conv->kernel_name = "scalar";
+
+	switch(conv->format)
+	{
+		case EVE_RGB565:
+			conv->kernel = rgba ? EVE_rgb565_4 : EVE_rgb565_3;
+			break;
+		case EVE_ARGB1555:
+			conv->kernel = rgba ? EVE_argb1555_4 : EVE_argb1555_3;
+			break;
+		case EVE_ARGB4:
+			conv->kernel = rgba ? EVE_argb4_4 : EVE_argb4_3;
+			break;
+		case EVE_L8:
+			conv->kernel = rgba ? EVE_l8_4 : EVE_l8_3;
+			break;
+		default:
+			conv->kernel = rgba ? EVE_l4_4 : EVE_l4_3;
+			break;
+	}
+
+	if((conv->options & (EVE_CONVERT_SCALAR | EVE_DITHER_ORDERED | EVE_DITHER_DIFFUSION)) != 0)
+	{
+		if((conv->options & (EVE_DITHER_ORDERED | EVE_DITHER_DIFFUSION)) != 0)
+		{
+			conv->kernel_name = "dither";
+		}
+		return;
+	}
+
+#if defined (EVE_SIMD_NAME)
+	if(rgba && (conv->format != EVE_L4))
+	{
+		conv->kernel_name = EVE_SIMD_NAME;
+
+		switch(conv->format)
+		{
+			case EVE_RGB565:
+				conv->kernel = EVE_x86_rgb565;
+				break;
+			case EVE_ARGB1555:
+				conv->kernel = EVE_x86_argb1555;
+				break;
+			case EVE_ARGB4:
+				conv->kernel = EVE_x86_argb4;
+				break;
+			default:
+				conv->kernel = EVE_x86_l8;
+				break;
+		}
+	}
+#endif
+
+#if defined (__ARM_NEON)
+	if(conv->format != EVE_L4)
+	{
+		conv->kernel_name = "NEON";
+
+		switch(conv->format)
+		{
+			case EVE_RGB565:
+				conv->kernel = rgba ? EVE_neon_rgb565_4 : EVE_neon_rgb565_3;
+				break;
+			case EVE_ARGB1555:
+				conv->kernel = rgba ? EVE_neon_argb1555_4 : EVE_neon_argb1555_3;
+				break;
+			case EVE_ARGB4:
+				conv->kernel = rgba ? EVE_neon_argb4_4 : EVE_neon_argb4_3;
+				break;
+			default:
+				conv->kernel = rgba ? EVE_neon_l8_4 : EVE_neon_l8_3;
+				break;
+		}
+	}
+#endif
+}
+
+
+/* format is EVE_RGB565, EVE_ARGB1555, EVE_ARGB4, EVE_L8 or EVE_L4, source is EVE_CONVERT_RGB888 or EVE_CONVERT_RGBA8888 */
+/* errors needs space for EVE_CONVERT_ERRORS(width) values with EVE_DITHER_DIFFUSION, returns 0 for invalid arguments */
+uint8_t EVE_convert_init(EVE_convert_t *conv, uint8_t format, uint8_t source, uint16_t width, uint8_t options, int16_t *errors)
+{
+	switch(format)
+	{
+		case EVE_RGB565:
+		case EVE_ARGB1555:
+		case EVE_ARGB4:
+			conv->stride = width * 2;
+			break;
+		case EVE_L8:
+			conv->stride = width;
+			break;
+		case EVE_L4:
+			conv->stride = (width + 1) / 2;
+			break;
+		default:
+			return 0;
+	}
+
+	if(((source != EVE_CONVERT_RGB888) && (source != EVE_CONVERT_RGBA8888)) || (((options & EVE_DITHER_DIFFUSION) != 0) && (errors == NULL)))
+	{
+		return 0;
+	}
+
+	conv->format = format;
+	conv->source = source;
+	conv->width = width;
+	conv->options = options;
+	conv->errors = errors;
+	EVE_convert_select(conv);
+	EVE_convert_restart(conv);
+	return 1;
+}
+
+
+/* start again with the first line */
+void EVE_convert_restart(EVE_convert_t *conv)
+{
+	conv->line = 0;
+
+	if(conv->errors != NULL)
+	{
+		memset(conv->errors, 0, EVE_CONVERT_ERRORS(conv->width) * sizeof(int16_t));
+	}
+}
+
+
+static void EVE_convert_dithered(EVE_convert_t *conv, uint8_t *dst, const uint8_t *src)
+{
+	static const uint8_t bits_rgb565[3] = {5, 6, 5};
+	static const uint8_t bits_argb1555[3] = {5, 5, 5};
+	static const uint8_t bits_argb4[3] = {4, 4, 4};
+	static const uint8_t bits_l8[1] = {8};
+	static const uint8_t bits_l4[1] = {4};
+	const uint8_t *bits;
+	int16_t *errors = conv->errors;
+	int16_t carry[3] = {0, 0, 0};
+	int16_t below[3] = {0, 0, 0};
+	int32_t value, error;
+	uint8_t channel[4];
+	uint8_t channels = 3;
+	uint16_t x, slot;
+	uint16_t packed;
+	uint8_t index, shift;
+
+	switch(conv->format)
+	{
+		case EVE_RGB565:
+			bits = bits_rgb565;
+			break;
+		case EVE_ARGB1555:
+			bits = bits_argb1555;
+			break;
+		case EVE_ARGB4:
+			bits = bits_argb4;
+			break;
+		case EVE_L8:
+			bits = bits_l8;
+			channels = 1;
+			break;
+		default:
+			bits = bits_l4;
+			channels = 1;
+			break;
+	}
+
+	for(x = 0; x < conv->width; x++)
+	{
+		channel[3] = (conv->source == EVE_CONVERT_RGBA8888) ? src[3] : 0xFF;
+
+		if(channels == 1)
+		{
+			channel[0] = EVE_luminance(src[0], src[1], src[2]);
+		}
+		else
+		{
+			channel[0] = src[0];
+			channel[1] = src[1];
+			channel[2] = src[2];
+		}
+
+		for(index = 0; index < channels; index++)
+		{
+			shift = 8 - bits[index];
+			value = channel[index];
+
+			if((conv->options & EVE_DITHER_ORDERED) != 0)
+			{
+				value += (EVE_bayer4[((conv->line & 3) * 4) + (x & 3)] << shift) >> 4;
+			}
+
+			if((conv->options & EVE_DITHER_DIFFUSION) != 0)
+			{
+				/* errors are kept in 1/16, slot x+1 holds the errors for pixel x from the line above */
+				slot = ((x + 1) * 4) + index;
+				value += (errors[slot] + carry[index]) / 16;
+			}
+
+			value = (value < 0) ? 0 : ((value > 255) ? 255 : value);
+			channel[index] = (uint8_t) ((value >> shift) << shift);
+
+			if((conv->options & EVE_DITHER_DIFFUSION) != 0)
+			{
+				error = value - channel[index];
+				errors[slot - 4] += (int16_t) (error * 3);	/* below left, its slot was already used */
+				errors[slot] = (int16_t) (below[index] + (error * 5));
+				below[index] = (int16_t) error;	/* below right, added when the next pixel is done */
+				carry[index] = (int16_t) (error * 7);
+			}
+		}
+
+		switch(conv->format)
+		{
+			case EVE_L8:
+				dst[x] = channel[0];
+				break;
+			case EVE_L4:
+				dst[x / 2] = (x & 1) ? (uint8_t) (dst[x / 2] | (channel[0] >> 4)) : (uint8_t) (channel[0] & 0xF0);
+				break;
+			default:
+				if(conv->format == EVE_RGB565)
+				{
+					packed = EVE_pack_rgb565(channel[0], channel[1], channel[2], channel[3]);
+				}
+				else if(conv->format == EVE_ARGB1555)
+				{
+					packed = EVE_pack_argb1555(channel[0], channel[1], channel[2], channel[3]);
+				}
+				else
+				{
+					packed = EVE_pack_argb4(channel[0], channel[1], channel[2], channel[3]);
+				}
+
+				dst[x * 2] = (uint8_t) packed;
+				dst[(x * 2) + 1] = (uint8_t) (packed >> 8);
+				break;
+		}
+
+		src += conv->source;
+	}
+
+	if((conv->options & EVE_DITHER_DIFFUSION) != 0)
+	{
+		for(index = 0; index < channels; index++)
+		{
+			errors[index] = 0;	/* the left of the first pixel, not used */
+		}
+	}
+}
+
+
+/* convert a line of width pixels, returns the number of bytes written to dst */
+uint16_t EVE_convert_line(EVE_convert_t *conv, uint8_t *dst, const uint8_t *src)
+{
+	if((conv->options & (EVE_DITHER_ORDERED | EVE_DITHER_DIFFUSION)) != 0)
+	{
+		EVE_convert_dithered(conv, dst, src);
+	}
+	else
+	{
+		conv->kernel(dst, src, conv->width);
+	}
+
+	conv->line++;
+	return conv->stride;
+}
+
+
+/* convert lines and write them to address in RAM_G, src_stride is the distance between the lines in the source */
+/* returns 0 if a single line does not fit into the buffer, this is meant to be called outside display-list building, does not support cmd-burst */
+uint8_t EVE_convert_upload(EVE_convert_t *conv, uint32_t address, const uint8_t *src, uint16_t lines, uint32_t src_stride)
+{
+	uint8_t *dst;
+	uint16_t count, index, space;
+#if !defined (EVE_DMA)
+	static uint8_t buffer[EVE_CONVERT_BUFFER];
+
+	space = EVE_CONVERT_BUFFER;
+#else
+	space = sizeof(EVE_dma_buffer) - 4;
+#endif
+
+	if((conv->stride == 0) || (conv->stride > space))
+	{
+		return 0;
+	}
+
+	space = space / conv->stride; /* lines per transfer */
+
+	while(lines != 0)
+	{
+		count = (lines < space) ? lines : space;
+
+#if defined (EVE_DMA)
+		while(EVE_dma_busy);
+
+		EVE_dma_buffer[0] = (uint8_t)(address >> 16) | MEM_WRITE;
+		EVE_dma_buffer[1] = (uint8_t)(address >> 8);
+		EVE_dma_buffer[2] = (uint8_t)(address);
+		dst = &EVE_dma_buffer[3];
+#else
+		dst = buffer;
+#endif
+
+		for(index = 0; index < count; index++)
+		{
+			dst += EVE_convert_line(conv, dst, src);
+			src += src_stride;
+		}
+
+#if defined (EVE_DMA)
+		EVE_dma_buffer_index = 3 + (count * conv->stride);
+		EVE_start_dma_transfer();
+#else
+		EVE_memWrite_sram_buffer(address, buffer, count * conv->stride);
+#endif
+
+		address += (uint32_t) count * conv->stride;
+		lines -= count;
+	}
+
+	return 1;
+}
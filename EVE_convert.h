@@ -0,0 +1,49 @@
+/*
+@file    EVE_convert.h
+@brief   prototypes for the conversion of RGB888 / RGBA8888 pixels to EVE bitmap formats
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_CONVERT_H_
+#define EVE_CONVERT_H_
+
+#define EVE_CONVERT_RGB888		3	/* the source formats, the value is the number of bytes per pixel */
+#define EVE_CONVERT_RGBA8888	4
+
+#define EVE_DITHER_ORDERED		0x01	/* options */
+#define EVE_DITHER_DIFFUSION	0x02
+#define EVE_CONVERT_SCALAR		0x80	/* do not use the SIMD kernels, for comparison */
+
+#define EVE_CONVERT_ERRORS(width) (((width) + 2) * 4)	/* int16_t needed for EVE_DITHER_DIFFUSION */
+
+#if !defined (EVE_CONVERT_BUFFER)
+#define EVE_CONVERT_BUFFER 2048	/* buffer for EVE_convert_upload() without EVE_DMA, needs to hold a line at least */
+#endif
+
+typedef struct
+{
+	void (*kernel)(uint8_t *dst, const uint8_t *src, uint16_t count);
+	const char *kernel_name;	/* "scalar", "SSE2", "AVX2", "NEON" or "dither" */
+	int16_t *errors;	/* EVE_CONVERT_ERRORS(width) for EVE_DITHER_DIFFUSION, NULL otherwise */
+	uint16_t width;
+	uint16_t stride;	/* bytes per line in the EVE format */
+	uint16_t line;
+	uint8_t format;
+	uint8_t source;
+	uint8_t options;
+} EVE_convert_t;
+
+uint8_t EVE_convert_init(EVE_convert_t *conv, uint8_t format, uint8_t source, uint16_t width, uint8_t options, int16_t *errors);
+void EVE_convert_restart(EVE_convert_t *conv);
+uint16_t EVE_convert_line(EVE_convert_t *conv, uint8_t *dst, const uint8_t *src);
+uint8_t EVE_convert_upload(EVE_convert_t *conv, uint32_t address, const uint8_t *src, uint16_t lines, uint32_t src_stride);
+
+#endif /* EVE_CONVERT_H_ */
@@ -0,0 +1,249 @@
+/*
+@file    EVE_file.c
+@brief   uploading files with CMD_INFLATE and CMD_LOADIMAGE on Linux hosts, without reading them into memory first
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+EVE_cmd_inflate() and EVE_cmd_loadimage() need all of the data in one buffer with a length of at most 65535 bytes.
+These take a file descriptor or a path instead and send the data right from the file:
+Regular files are mapped with mmap() and the pages are send from the mapping as they are read in by the kernel,
+everything else, or all files when EVE_FILE_NO_MMAP is defined, is read into a buffer of EVE_FILE_BUFFER bytes
+with the kernel reading ahead since the file is marked for sequential access.
+Either way the memory needed does not grow with the size of the file and the length is 32 bit.
+
+progress is called with the number of bytes send so far after every block, it can be 0.
+With a length of 0 the size of the file is used, that only works for regular files.
+When the file ends before length bytes were send the rest is filled with zeros so that the co-processor
+is not left waiting for data, 0 is returned then.
+For data that does not come from a file, or should not block until all of it was send, use EVE_mediafifo.c.
+
+EVE_file_loadimage_path(MEM_PIC, EVE_OPT_NODL, "/usr/share/ui/background.jpg", show_progress);
+
+This is meant to be called outside display-list building, it includes executing the command and waiting for completion, does not support cmd-burst.
+There is no Linux target in EVE_config.h, the functions to talk to the SPI need to be supplied there for the host that is used.
+
+@section History
+
+4.1
+- first version
+- builds with -std=c99 as well, uses posix_madvise()
+
+*/
+
+#define _POSIX_C_SOURCE 200809L /* before any system header, for posix_madvise(), posix_fadvise() and O_CLOEXEC */
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_file.h"
+
+#if defined (__linux__)
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define EVE_FILE_BLOCK 61440UL /* bytes passed to block_transfer() at once, a multiple of 3840 */
+
+
+/* the size of what is left of a regular file from the current position, 0 for everything else */
+static uint32_t EVE_file_size(int fd)
+{
+	struct stat status;
+	off_t position;
+
+	if((fstat(fd, &status) != 0) || !S_ISREG(status.st_mode))
+	{
+		return 0;
+	}
+
+	position = lseek(fd, 0, SEEK_CUR);
+
+	if((position < 0) || (position >= status.st_size) || ((status.st_size - position) > 0xFFFFFFFFL))
+	{
+		return 0;
+	}
+
+	return (uint32_t) (status.st_size - position);
+}
+
+
+/* sends length bytes from the file to the command FIFO, returns 0 if the file was not long enough */
+static uint8_t EVE_file_send(int fd, uint32_t length, EVE_file_progress_t progress)
+{
+	static uint8_t buffer[EVE_FILE_BUFFER];
+	uint32_t done = 0;
+	uint32_t block;
+	uint8_t result = 1;
+	ssize_t count, part;
+#if !defined (EVE_FILE_NO_MMAP)
+	uint8_t *map = MAP_FAILED;
+	off_t position;
+	uint32_t skip;
+
+	/* only map what is in the file, reading a page past its end would raise SIGBUS */
+	if(EVE_file_size(fd) >= length)
+	{
+		/* the mapping needs to start on a page, skip is where the current position of the file is in that page */
+		position = lseek(fd, 0, SEEK_CUR);
+		skip = (uint32_t) (position & ((off_t) sysconf(_SC_PAGESIZE) - 1));
+		map = mmap(0, (size_t) length + skip, PROT_READ, MAP_PRIVATE, fd, position - skip);
+	}
+
+	if(map != MAP_FAILED)
+	{
+		posix_madvise(map, (size_t) length + skip, POSIX_MADV_SEQUENTIAL);
+
+		for(done = 0; done < length; done += block)
+		{
+			block = ((length - done) < EVE_FILE_BLOCK) ? (length - done) : EVE_FILE_BLOCK;
+			block_transfer(&map[skip + done], (uint16_t) block);
+
+			if(progress != 0)
+			{
+				progress(done + block, length);
+			}
+		}
+
+		munmap(map, (size_t) length + skip);
+		lseek(fd, length, SEEK_CUR);
+		return 1;
+	}
+#endif
+
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	while(done < length)
+	{
+		block = ((length - done) < EVE_FILE_BUFFER) ? (length - done) : EVE_FILE_BUFFER;
+		count = 0;
+
+		/* the blocks need to be a multiple of four bytes, read() can return less than asked for */
+		while(((uint32_t) count < block) && (result != 0))
+		{
+			part = read(fd, &buffer[count], block - (uint32_t) count);
+
+			if(part <= 0)
+			{
+				memset(&buffer[count], 0, block - (uint32_t) count);
+				result = 0;
+				break;
+			}
+
+			count += part;
+		}
+
+		if(result == 0)
+		{
+			/* keep the co-processor going with zeros, it would wait forever otherwise */
+			while(done < length)
+			{
+				block = ((length - done) < EVE_FILE_BUFFER) ? (length - done) : EVE_FILE_BUFFER;
+				block_transfer(buffer, (uint16_t) block);
+				memset(buffer, 0, EVE_FILE_BUFFER);
+				done += block;
+			}
+			break;
+		}
+
+		block_transfer(buffer, (uint16_t) block);
+		done += block;
+
+		if(progress != 0)
+		{
+			progress(done, length);
+		}
+	}
+
+	return result;
+}
+
+
+/* inflates length bytes of fd to ptr, length 0 is the rest of the file, returns 0 on failure */
+/* this is meant to be called outside display-list building, it includes executing the command and waiting for completion, does not support cmd-burst */
+uint8_t EVE_file_inflate(uint32_t ptr, int fd, uint32_t length, EVE_file_progress_t progress)
+{
+	if(length == 0)
+	{
+		length = EVE_file_size(fd);
+	}
+
+	if(length == 0)
+	{
+		return 0;
+	}
+
+	EVE_cmd_inflate(ptr, 0, 0);
+	return EVE_file_send(fd, length, progress);
+}
+
+
+/* decodes a JPEG or PNG of length bytes from fd to ptr, length 0 is the rest of the file, returns 0 on failure */
+/* with EVE_OPT_MEDIAFIFO or EVE_OPT_FLASH the data does not come thru the command FIFO, use EVE_cmd_loadimage() then */
+/* this is meant to be called outside display-list building, it includes executing the command and waiting for completion, does not support cmd-burst */
+uint8_t EVE_file_loadimage(uint32_t ptr, uint32_t options, int fd, uint32_t length, EVE_file_progress_t progress)
+{
+	if(length == 0)
+	{
+		length = EVE_file_size(fd);
+	}
+
+	if(length == 0)
+	{
+		return 0;
+	}
+
+	#if defined (FT81X_ENABLE)
+	if((options & EVE_OPT_MEDIAFIFO) != 0)
+	{
+		return 0;
+	}
+	#endif
+
+	#if defined (BT81X_ENABLE)
+	if((options & EVE_OPT_FLASH) != 0)
+	{
+		return 0;
+	}
+	#endif
+
+	EVE_cmd_loadimage(ptr, options, 0, 0);
+	return EVE_file_send(fd, length, progress);
+}
+
+
+uint8_t EVE_file_inflate_path(uint32_t ptr, const char *path, EVE_file_progress_t progress)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	uint8_t result;
+
+	if(fd < 0)
+	{
+		return 0;
+	}
+
+	result = EVE_file_inflate(ptr, fd, 0, progress);
+	close(fd);
+	return result;
+}
+
+
+uint8_t EVE_file_loadimage_path(uint32_t ptr, uint32_t options, const char *path, EVE_file_progress_t progress)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	uint8_t result;
+
+	if(fd < 0)
+	{
+		return 0;
+	}
+
+	result = EVE_file_loadimage(ptr, options, fd, 0, progress);
+	close(fd);
+	return result;
+}
+
+#endif /* __linux__ */
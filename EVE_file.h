@@ -0,0 +1,33 @@
+/*
+@file    EVE_file.h
+@brief   prototypes for uploading files with CMD_INFLATE and CMD_LOADIMAGE on Linux hosts
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_FILE_H_
+#define EVE_FILE_H_
+
+#if defined (__linux__)
+
+#if !defined (EVE_FILE_BUFFER)
+#define EVE_FILE_BUFFER 15360	/* for reading files that can not be mapped, a multiple of 3840 */
+#endif
+
+typedef void (*EVE_file_progress_t)(uint32_t done, uint32_t total);
+
+uint8_t EVE_file_inflate(uint32_t ptr, int fd, uint32_t length, EVE_file_progress_t progress);
+uint8_t EVE_file_loadimage(uint32_t ptr, uint32_t options, int fd, uint32_t length, EVE_file_progress_t progress);
+uint8_t EVE_file_inflate_path(uint32_t ptr, const char *path, EVE_file_progress_t progress);
+uint8_t EVE_file_loadimage_path(uint32_t ptr, uint32_t options, const char *path, EVE_file_progress_t progress);
+
+#endif /* __linux__ */
+
+#endif /* EVE_FILE_H_ */
@@ -0,0 +1,165 @@
+/*
+@file    EVE_flashdelta.c
+@brief   programs only the sectors of the BT81x flash that differ from a new image
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+Sending a complete image thru RAM_G for CMD_FLASHUPDATE takes long, even when most of it did not change.
+EVE_flashdelta() reads the flash into RAM_G in batches with CMD_FLASHREAD, has the chip calculate the CRC-32 of each
+sector of 4096 bytes with CMD_MEMCRC and compares these with the CRC-32 of the same sectors of the new image on the host.
+Only the sectors that differ are send to RAM_G, runs of them are programmed with a single CMD_FLASHUPDATE.
+The sectors that were programmed are checked again afterwards.
+
+The last sector of the image is filled up with 0xFF, the image always covers whole sectors.
+The scratch area in RAM_G needs to be at least 4096 bytes, a larger area allows larger batches,
+up to EVE_FLASHDELTA_BATCH sectors.
+
+EVE_flashdelta_t report;
+EVE_init_flash();
+EVE_flashdelta(EVE_FLASHFS_DATA, image, sizeof(image), 0x80000, 0x40000, &report);
+printf("%lu of %lu sectors changed, %lu bytes saved\n", report.changed, report.sectors, report.saved);
+
+This is meant to be called outside display-list building, it includes executing the commands and waiting for completion, does not support cmd-burst.
+The flash needs to be in full mode, see EVE_init_flash().
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_flashfs.h"
+#include "EVE_flashdelta.h"
+
+#if defined (BT81X_ENABLE)
+
+/* CRC-32 of a sector of the image as it will be in the flash */
+static uint32_t EVE_flashdelta_crc(const uint8_t *image, uint32_t size, uint32_t sector)
+{
+	static const uint8_t erased[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+	uint32_t start = sector * EVE_FLASHFS_SECTOR;
+	uint32_t length = ((size - start) < EVE_FLASHFS_SECTOR) ? (size - start) : EVE_FLASHFS_SECTOR;
+	uint32_t crc, chunk;
+
+	crc = EVE_flashfs_crc32(0, &image[start], length);
+
+	/* the last sector is padded to exactly EVE_FLASHFS_SECTOR bytes, the image does not need to be a multiple of 16 */
+	for(; length < EVE_FLASHFS_SECTOR; length += chunk)
+	{
+		chunk = ((EVE_FLASHFS_SECTOR - length) < 16) ? (EVE_FLASHFS_SECTOR - length) : 16;
+		crc = EVE_flashfs_crc32(crc, erased, chunk);
+	}
+
+	return crc;
+}
+
+
+/* reads count sectors from the flash into scratch and gets their CRC-32 from the chip */
+static void EVE_flashdelta_chip(uint32_t flash, uint32_t scratch, uint8_t count, uint32_t *crc)
+{
+	uint16_t offset[EVE_FLASHDELTA_BATCH];
+	uint8_t index;
+
+	EVE_cmd_flashread(scratch, flash, count * EVE_FLASHFS_SECTOR);
+
+	for(index = 0; index < count; index++)
+	{
+		offset[index] = EVE_cmd_memcrc(scratch + (index * EVE_FLASHFS_SECTOR), EVE_FLASHFS_SECTOR);
+	}
+
+	EVE_cmd_execute();
+
+	for(index = 0; index < count; index++)
+	{
+		crc[index] = EVE_memRead32(EVE_RAM_CMD + offset[index]);
+	}
+}
+
+
+/* offset needs to be 4096-byte aligned, returns 1 when all sectors match the image afterwards */
+uint8_t EVE_flashdelta(uint32_t offset, const uint8_t *image, uint32_t size, uint32_t scratch, uint32_t scratch_size, EVE_flashdelta_t *report)
+{
+	uint32_t chip[EVE_FLASHDELTA_BATCH];
+	uint32_t host[EVE_FLASHDELTA_BATCH];
+	uint32_t sector, start, length, changed;
+	uint8_t batch, count, index, first;
+
+	memset(report, 0, sizeof(EVE_flashdelta_t));
+
+	if(((offset & (EVE_FLASHFS_SECTOR - 1)) != 0) || (scratch_size < EVE_FLASHFS_SECTOR))
+	{
+		return 0;
+	}
+
+	batch = ((scratch_size / EVE_FLASHFS_SECTOR) < EVE_FLASHDELTA_BATCH) ? (uint8_t) (scratch_size / EVE_FLASHFS_SECTOR) : EVE_FLASHDELTA_BATCH;
+	report->sectors = (size + EVE_FLASHFS_SECTOR - 1) / EVE_FLASHFS_SECTOR;
+
+	for(sector = 0; sector < report->sectors; sector += count)
+	{
+		count = ((report->sectors - sector) < batch) ? (uint8_t) (report->sectors - sector) : batch;
+		changed = report->changed;
+		EVE_flashdelta_chip(offset + (sector * EVE_FLASHFS_SECTOR), scratch, count, chip);
+
+		for(index = 0; index < count; index++)
+		{
+			host[index] = EVE_flashdelta_crc(image, size, sector + index);
+		}
+
+		index = 0;
+
+		while(index < count)
+		{
+			if(host[index] == chip[index])
+			{
+				index++;
+				continue;
+			}
+
+			/* a run of sectors that differ, the flash contents in scratch are replaced with the image */
+			first = index;
+
+			while((index < count) && (host[index] != chip[index]))
+			{
+				start = (sector + index) * EVE_FLASHFS_SECTOR;
+				length = ((size - start) < EVE_FLASHFS_SECTOR) ? (size - start) : EVE_FLASHFS_SECTOR;
+				EVE_memWrite_sram_buffer(scratch + (index * EVE_FLASHFS_SECTOR), &image[start], (uint16_t) length);
+
+				if(length < EVE_FLASHFS_SECTOR)
+				{
+					EVE_cmd_memset(scratch + (index * EVE_FLASHFS_SECTOR) + length, 0xFF, EVE_FLASHFS_SECTOR - length);
+				}
+
+				report->written += length;
+				index++;
+			}
+
+			EVE_cmd_flashupdate(offset + ((sector + first) * EVE_FLASHFS_SECTOR), scratch + (first * EVE_FLASHFS_SECTOR), (index - first) * EVE_FLASHFS_SECTOR);
+			report->changed += index - first;
+		}
+
+		if(report->changed != changed) /* something was programmed in this batch, check it */
+		{
+			EVE_flashdelta_chip(offset + (sector * EVE_FLASHFS_SECTOR), scratch, count, chip);
+
+			for(index = 0; index < count; index++)
+			{
+				if(host[index] != chip[index])
+				{
+					report->failed++;
+				}
+			}
+		}
+	}
+
+	report->saved = size - report->written;
+	return (report->failed == 0);
+}
+
+#endif /* BT81X_ENABLE */
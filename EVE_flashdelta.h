@@ -0,0 +1,35 @@
+/*
+@file    EVE_flashdelta.h
+@brief   prototypes for programming only the sectors of the BT81x flash that changed
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_FLASHDELTA_H_
+#define EVE_FLASHDELTA_H_
+
+#if defined (BT81X_ENABLE)
+
+#define EVE_FLASHDELTA_BATCH 64	/* maximum number of sectors that are compared at once, each takes 16 bytes in the command FIFO */
+
+typedef struct
+{
+	uint32_t sectors;	/* sectors in the image */
+	uint32_t changed;	/* sectors that were programmed */
+	uint32_t written;	/* bytes send to the chip for programming */
+	uint32_t saved;		/* bytes that did not need to be send */
+	uint32_t failed;	/* sectors that still differed after programming */
+} EVE_flashdelta_t;
+
+uint8_t EVE_flashdelta(uint32_t offset, const uint8_t *image, uint32_t size, uint32_t scratch, uint32_t scratch_size, EVE_flashdelta_t *report);
+
+#endif /* BT81X_ENABLE */
+
+#endif /* EVE_FLASHDELTA_H_ */
@@ -0,0 +1,420 @@
+/*
+@file    EVE_flashfs.c
+@brief   asset directory in the external flash of BT81x, assets are found by name or id without reading the flash
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+The flash commands work with plain addresses, this keeps a directory of the assets in the sector after the blob
+so that the application does not need to track the offsets.
+The directory is read once by EVE_flashfs_mount() and kept on the host, finding an asset does not touch the flash.
+
+Layout of the flash:
+0x000000	blob
+0x001000	directory at EVE_RAM_FLASH_POSTBLOB: 32 bytes header, 32 bytes for each entry
+0x002000	data from EVE_FLASHFS_DATA, each asset starts on a sector of 4096 bytes
+
+eve_pack -f places its image at EVE_FLASHFS_DATA by default, when both are used EVE_FLASHFS_DATA needs to be
+defined behind the image, the FLASH_..._END of the generated header rounded up to the next sector.
+
+Header: magic "EVFS", version (16 bit), number of entries (16 bit), CRC-32 of the entries, 20 bytes 0xFF.
+Entry: name (12 bytes, zero terminated), id (16 bit), format, flags, width (16 bit), height (16 bit),
+offset, size and CRC-32 of the data (32 bit each), all little endian.
+
+A bitmap is copied to RAM_G by EVE_flashfs_load(), deflated assets are inflated with CMD_INFLATE2 from the flash.
+ASTC bitmaps can be used directly from the flash with BITMAP_SOURCE(EVE_flashfs_source(entry)).
+EVE_flashfs_check() compares the CRC-32 in the directory with CMD_MEMCRC over the data in RAM_G.
+
+EVE_init_flash();
+if(EVE_flashfs_mount(MEM_SCRATCH) == 0)
+{
+	EVE_flashfs_format(MEM_SCRATCH);
+	EVE_flashfs_add("logo", 1, EVE_ARGB4, 0, 64, 64, logo, sizeof(logo), MEM_SCRATCH);
+}
+EVE_flashfs_load(EVE_flashfs_find("logo"), MEM_LOGO);
+
+All functions but the lookups use the co-processor and are meant to be called outside display-list building, they do not support cmd-burst.
+The scratch area needs EVE_FLASHFS_SCRATCH bytes of RAM_G, the flash needs to be in full mode, see EVE_init_flash().
+Assets are only ever added at the end, EVE_flashfs_format() starts over.
+A directory with more entries than EVE_FLASHFS_ENTRIES is mounted with only the first EVE_FLASHFS_ENTRIES,
+EVE_flashfs_mount() returns EVE_FLASHFS_PARTIAL then and EVE_flashfs_add() refuses to write the directory back,
+only a return value of 0 means that there is no directory to keep.
+
+@section History
+
+4.1
+- first version
+- a directory with more entries than EVE_FLASHFS_ENTRIES is mounted partially instead of being reported as invalid
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_flashfs.h"
+
+#if defined (BT81X_ENABLE)
+
+#define EVE_FLASHFS_HEADER	32
+#define EVE_FLASHFS_ENTRY	32
+
+#if EVE_FLASHFS_ENTRIES > EVE_FLASHFS_MAX
+#error "EVE_FLASHFS_ENTRIES is more than the directory sector can hold"
+#endif
+
+static EVE_flashfs_entry_t flashfs_entries[EVE_FLASHFS_ENTRIES];
+static uint8_t flashfs_count = 0;
+static uint8_t flashfs_mounted = 0;
+static uint32_t flashfs_top = EVE_FLASHFS_DATA; /* the first free sector after all assets, including the ones not cached */
+
+
+/* the CRC-32 of zlib and CMD_MEMCRC, start with crc = 0 */
+uint32_t EVE_flashfs_crc32(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	static const uint32_t table[16] =
+	{
+		0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL, 0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+		0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL, 0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+	};
+
+	crc = ~crc;
+
+	while(length != 0)
+	{
+		crc ^= *data++;
+		crc = (crc >> 4) ^ table[crc & 0x0F];
+		crc = (crc >> 4) ^ table[crc & 0x0F];
+		length--;
+	}
+
+	return ~crc;
+}
+
+
+static void EVE_flashfs_put16(uint8_t *buffer, uint16_t value)
+{
+	buffer[0] = (uint8_t) value;
+	buffer[1] = (uint8_t) (value >> 8);
+}
+
+
+static void EVE_flashfs_put32(uint8_t *buffer, uint32_t value)
+{
+	buffer[0] = (uint8_t) value;
+	buffer[1] = (uint8_t) (value >> 8);
+	buffer[2] = (uint8_t) (value >> 16);
+	buffer[3] = (uint8_t) (value >> 24);
+}
+
+
+static uint16_t EVE_flashfs_get16(const uint8_t *buffer)
+{
+	return (uint16_t) (buffer[0] | (buffer[1] << 8));
+}
+
+
+static uint32_t EVE_flashfs_get32(const uint8_t *buffer)
+{
+	return ((uint32_t) buffer[0]) | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+
+static void EVE_flashfs_pack(const EVE_flashfs_entry_t *entry, uint8_t *buffer)
+{
+	memcpy(buffer, entry->name, EVE_FLASHFS_NAME);
+	EVE_flashfs_put16(&buffer[12], entry->id);
+	buffer[14] = entry->format;
+	buffer[15] = entry->flags;
+	EVE_flashfs_put16(&buffer[16], entry->width);
+	EVE_flashfs_put16(&buffer[18], entry->height);
+	EVE_flashfs_put32(&buffer[20], entry->offset);
+	EVE_flashfs_put32(&buffer[24], entry->size);
+	EVE_flashfs_put32(&buffer[28], entry->crc);
+}
+
+
+static void EVE_flashfs_unpack(EVE_flashfs_entry_t *entry, const uint8_t *buffer)
+{
+	memcpy(entry->name, buffer, EVE_FLASHFS_NAME);
+	entry->name[EVE_FLASHFS_NAME - 1] = 0;
+	entry->id = EVE_flashfs_get16(&buffer[12]);
+	entry->format = buffer[14];
+	entry->flags = buffer[15];
+	entry->width = EVE_flashfs_get16(&buffer[16]);
+	entry->height = EVE_flashfs_get16(&buffer[18]);
+	entry->offset = EVE_flashfs_get32(&buffer[20]);
+	entry->size = EVE_flashfs_get32(&buffer[24]);
+	entry->crc = EVE_flashfs_get32(&buffer[28]);
+}
+
+
+static void EVE_flashfs_read(uint32_t address, uint8_t *buffer, uint8_t length)
+{
+	uint8_t index;
+
+	for(index = 0; index < length; index += 4)
+	{
+		EVE_flashfs_put32(&buffer[index], EVE_memRead32(address + index));
+	}
+}
+
+
+/* the sector behind an asset */
+static uint32_t EVE_flashfs_last(const EVE_flashfs_entry_t *entry)
+{
+	return entry->offset + ((entry->size + EVE_FLASHFS_SECTOR - 1) & ~(EVE_FLASHFS_SECTOR - 1));
+}
+
+
+/* reads the directory into the host cache, returns 1 if it was mounted, EVE_FLASHFS_PARTIAL if only the first EVE_FLASHFS_ENTRIES are cached */
+/* and 0 if there is no valid directory */
+uint8_t EVE_flashfs_mount(uint32_t scratch)
+{
+	EVE_flashfs_entry_t entry;
+	uint8_t buffer[EVE_FLASHFS_ENTRY];
+	uint32_t crc = 0;
+	uint32_t expected, top;
+	uint16_t count;
+	uint8_t index;
+
+	flashfs_mounted = 0;
+	flashfs_count = 0;
+	flashfs_top = EVE_FLASHFS_DATA;
+
+	EVE_cmd_flashread(scratch, EVE_FLASHFS_DIRECTORY, EVE_FLASHFS_SECTOR);
+	EVE_flashfs_read(scratch, buffer, EVE_FLASHFS_HEADER);
+	count = EVE_flashfs_get16(&buffer[6]);
+	expected = EVE_flashfs_get32(&buffer[8]);
+
+	if((EVE_flashfs_get32(&buffer[0]) != EVE_FLASHFS_MAGIC) || (EVE_flashfs_get16(&buffer[4]) != EVE_FLASHFS_VERSION) || (count > EVE_FLASHFS_MAX))
+	{
+		return 0;
+	}
+
+	top = EVE_FLASHFS_DATA;
+
+	/* all entries are checked, the ones that do not fit into the cache still take up space in the flash */
+	for(index = 0; index < count; index++)
+	{
+		EVE_flashfs_read(scratch + EVE_FLASHFS_HEADER + (index * EVE_FLASHFS_ENTRY), buffer, EVE_FLASHFS_ENTRY);
+		crc = EVE_flashfs_crc32(crc, buffer, EVE_FLASHFS_ENTRY);
+		EVE_flashfs_unpack(&entry, buffer);
+
+		if(EVE_flashfs_last(&entry) > top)
+		{
+			top = EVE_flashfs_last(&entry);
+		}
+
+		if(index < EVE_FLASHFS_ENTRIES)
+		{
+			flashfs_entries[index] = entry;
+		}
+	}
+
+	if(crc != expected)
+	{
+		return 0;
+	}
+
+	flashfs_top = top;
+
+	if(count > EVE_FLASHFS_ENTRIES)
+	{
+		flashfs_count = EVE_FLASHFS_ENTRIES;
+		return EVE_FLASHFS_PARTIAL; /* not mounted for writing, EVE_flashfs_add() would drop the entries that are not cached */
+	}
+
+	flashfs_count = (uint8_t) count;
+	flashfs_mounted = 1;
+	return 1;
+}
+
+
+/* writes the cached directory to the flash */
+static void EVE_flashfs_write_directory(uint32_t scratch)
+{
+	uint8_t buffer[EVE_FLASHFS_ENTRY];
+	uint32_t crc = 0;
+	uint8_t index;
+
+	EVE_cmd_memset(scratch, 0xFF, EVE_FLASHFS_SECTOR);
+	EVE_cmd_execute(); /* the entries are written directly, the memset needs to be done first */
+
+	for(index = 0; index < flashfs_count; index++)
+	{
+		EVE_flashfs_pack(&flashfs_entries[index], buffer);
+		crc = EVE_flashfs_crc32(crc, buffer, EVE_FLASHFS_ENTRY);
+		EVE_memWrite_sram_buffer(scratch + EVE_FLASHFS_HEADER + (index * EVE_FLASHFS_ENTRY), buffer, EVE_FLASHFS_ENTRY);
+	}
+
+	memset(buffer, 0xFF, EVE_FLASHFS_HEADER);
+	EVE_flashfs_put32(&buffer[0], EVE_FLASHFS_MAGIC);
+	EVE_flashfs_put16(&buffer[4], EVE_FLASHFS_VERSION);
+	EVE_flashfs_put16(&buffer[6], flashfs_count);
+	EVE_flashfs_put32(&buffer[8], crc);
+	EVE_memWrite_sram_buffer(scratch, buffer, EVE_FLASHFS_HEADER);
+
+	EVE_cmd_flashupdate(EVE_FLASHFS_DIRECTORY, scratch, EVE_FLASHFS_SECTOR);
+}
+
+
+/* writes an empty directory, the data of the assets stays in the flash until it is overwritten */
+void EVE_flashfs_format(uint32_t scratch)
+{
+	flashfs_count = 0;
+	flashfs_top = EVE_FLASHFS_DATA;
+	EVE_flashfs_write_directory(scratch);
+	flashfs_mounted = 1;
+}
+
+
+/* bytes left in the flash behind the last asset */
+uint32_t EVE_flashfs_free(void)
+{
+	uint32_t size = EVE_memRead32(REG_FLASH_SIZE) * 1048576UL;
+	uint32_t end = flashfs_top;
+
+	return (size > end) ? (size - end) : 0;
+}
+
+
+/* writes data to the flash behind the last asset and adds it to the directory, returns 0 if the name or id is taken or there is no space */
+const EVE_flashfs_entry_t *EVE_flashfs_add(const char *name, uint16_t id, uint8_t format, uint8_t flags, uint16_t width, uint16_t height,
+	const uint8_t *data, uint32_t size, uint32_t scratch)
+{
+	EVE_flashfs_entry_t *entry;
+	uint32_t done, chunk;
+
+	if((flashfs_mounted == 0) || (flashfs_count >= EVE_FLASHFS_ENTRIES) || (strlen(name) >= EVE_FLASHFS_NAME) ||
+		(EVE_flashfs_find(name) != 0) || (EVE_flashfs_find_id(id) != 0) || (size > EVE_flashfs_free()))
+	{
+		return 0;
+	}
+
+	entry = &flashfs_entries[flashfs_count];
+	memset(entry, 0, sizeof(EVE_flashfs_entry_t));
+	strcpy(entry->name, name);
+	entry->id = id;
+	entry->format = format;
+	entry->flags = flags;
+	entry->width = width;
+	entry->height = height;
+	entry->offset = flashfs_top;
+	entry->size = size;
+	entry->crc = EVE_flashfs_crc32(0, data, size);
+
+	/* a sector at a time thru RAM_G, CMD_FLASHUPDATE only erases and writes the sectors that changed */
+	for(done = 0; done < size; done += chunk)
+	{
+		chunk = ((size - done) < EVE_FLASHFS_SECTOR) ? (size - done) : EVE_FLASHFS_SECTOR;
+		EVE_memWrite_sram_buffer(scratch, &data[done], (uint16_t) chunk);
+
+		if(chunk < EVE_FLASHFS_SECTOR)
+		{
+			EVE_cmd_memset(scratch + chunk, 0xFF, EVE_FLASHFS_SECTOR - chunk);
+		}
+
+		EVE_cmd_flashupdate(entry->offset + done, scratch, EVE_FLASHFS_SECTOR);
+	}
+
+	flashfs_count++;
+	flashfs_top = EVE_flashfs_last(entry);
+	EVE_flashfs_write_directory(scratch);
+	return entry;
+}
+
+
+uint8_t EVE_flashfs_count(void)
+{
+	return flashfs_count;
+}
+
+
+const EVE_flashfs_entry_t *EVE_flashfs_entry(uint8_t index)
+{
+	return (index < flashfs_count) ? &flashfs_entries[index] : 0;
+}
+
+
+const EVE_flashfs_entry_t *EVE_flashfs_find(const char *name)
+{
+	uint8_t index;
+
+	for(index = 0; index < flashfs_count; index++)
+	{
+		if(strncmp(flashfs_entries[index].name, name, EVE_FLASHFS_NAME) == 0)
+		{
+			return &flashfs_entries[index];
+		}
+	}
+
+	return 0;
+}
+
+
+const EVE_flashfs_entry_t *EVE_flashfs_find_id(uint16_t id)
+{
+	uint8_t index;
+
+	for(index = 0; index < flashfs_count; index++)
+	{
+		if(flashfs_entries[index].id == id)
+		{
+			return &flashfs_entries[index];
+		}
+	}
+
+	return 0;
+}
+
+
+/* copies an asset to dest in RAM_G, deflated assets are inflated, dest needs to be 4-byte aligned */
+uint8_t EVE_flashfs_load(const EVE_flashfs_entry_t *entry, uint32_t dest)
+{
+	if(entry == 0)
+	{
+		return 0;
+	}
+
+	if((entry->flags & EVE_FLASHFS_DEFLATED) != 0)
+	{
+		EVE_cmd_flashsource(entry->offset);
+		EVE_cmd_inflate2(dest, EVE_OPT_FLASH, 0, 0);
+		EVE_cmd_execute();
+	}
+	else
+	{
+		EVE_cmd_flashread(dest, entry->offset, (entry->size + 3) & ~3UL);
+	}
+
+	return 1;
+}
+
+
+/* copies the stored bytes of an asset to dest in RAM_G and checks them with CMD_MEMCRC, returns 1 if the CRC matches */
+uint8_t EVE_flashfs_check(const EVE_flashfs_entry_t *entry, uint32_t dest)
+{
+	uint16_t offset;
+
+	if(entry == 0)
+	{
+		return 0;
+	}
+
+	EVE_cmd_flashread(dest, entry->offset, (entry->size + 3) & ~3UL);
+	offset = EVE_cmd_memcrc(dest, entry->size);
+	EVE_cmd_execute();
+
+	return (EVE_memRead32(EVE_RAM_CMD + offset) == entry->crc);
+}
+
+
+/* the address for BITMAP_SOURCE to use an ASTC bitmap directly from the flash */
+uint32_t EVE_flashfs_source(const EVE_flashfs_entry_t *entry)
+{
+	return EVE_RAM_FLASH | (entry->offset / 32);
+}
+
+#endif /* BT81X_ENABLE */
@@ -0,0 +1,75 @@
+/*
+@file    EVE_flashfs.h
+@brief   prototypes for the asset directory in the external flash of BT81x
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+- the directory follows EVE_RAM_FLASH_POSTBLOB, EVE_FLASHFS_DATA can be set from outside
+- added EVE_FLASHFS_PARTIAL
+
+*/
+
+#ifndef EVE_FLASHFS_H_
+#define EVE_FLASHFS_H_
+
+#if defined (BT81X_ENABLE)
+
+#define EVE_FLASHFS_DIRECTORY	(EVE_RAM_FLASH_POSTBLOB - EVE_RAM_FLASH)	/* the directory sector in the flash, right after the blob */
+
+#if !defined (EVE_FLASHFS_DATA)
+#define EVE_FLASHFS_DATA (EVE_FLASHFS_DIRECTORY + EVE_FLASHFS_SECTOR)	/* the first extent, move it behind the image of eve_pack -f when both are used */
+#endif
+
+#define EVE_FLASHFS_SECTOR		4096UL
+#define EVE_FLASHFS_MAGIC		0x53465645UL	/* "EVFS" */
+#define EVE_FLASHFS_VERSION		1
+#define EVE_FLASHFS_NAME		12		/* including the terminating zero */
+#define EVE_FLASHFS_MAX			127		/* entries that fit into the directory sector */
+#define EVE_FLASHFS_SCRATCH		4096UL	/* bytes of RAM_G needed at the scratch address */
+
+#if !defined (EVE_FLASHFS_ENTRIES)
+#define EVE_FLASHFS_ENTRIES 32	/* entries cached on the host, at most EVE_FLASHFS_MAX */
+#endif
+
+#define EVE_FLASHFS_DEFLATED	0x01	/* flags, the data is a zlib stream for CMD_INFLATE2 */
+
+#define EVE_FLASHFS_PARTIAL		2	/* EVE_flashfs_mount(), the directory is valid but has more than EVE_FLASHFS_ENTRIES entries */
+
+typedef struct
+{
+	char name[EVE_FLASHFS_NAME];
+	uint16_t id;
+	uint8_t format;		/* the bitmap format like EVE_RGB565, or anything else for data that is not a bitmap */
+	uint8_t flags;
+	uint16_t width;
+	uint16_t height;
+	uint32_t offset;	/* in the flash, 4096-byte aligned */
+	uint32_t size;		/* bytes as they are stored */
+	uint32_t crc;		/* CRC-32 of the stored bytes, the same CMD_MEMCRC calculates */
+} EVE_flashfs_entry_t;
+
+uint32_t EVE_flashfs_crc32(uint32_t crc, const uint8_t *data, uint32_t length);
+
+uint8_t EVE_flashfs_mount(uint32_t scratch);
+void EVE_flashfs_format(uint32_t scratch);
+const EVE_flashfs_entry_t *EVE_flashfs_add(const char *name, uint16_t id, uint8_t format, uint8_t flags, uint16_t width, uint16_t height,
+	const uint8_t *data, uint32_t size, uint32_t scratch);
+
+uint8_t EVE_flashfs_count(void);
+const EVE_flashfs_entry_t *EVE_flashfs_entry(uint8_t index);
+const EVE_flashfs_entry_t *EVE_flashfs_find(const char *name);
+const EVE_flashfs_entry_t *EVE_flashfs_find_id(uint16_t id);
+uint32_t EVE_flashfs_free(void);
+
+uint8_t EVE_flashfs_load(const EVE_flashfs_entry_t *entry, uint32_t dest);
+uint8_t EVE_flashfs_check(const EVE_flashfs_entry_t *entry, uint32_t dest);
+uint32_t EVE_flashfs_source(const EVE_flashfs_entry_t *entry);
+
+#endif /* BT81X_ENABLE */
+
+#endif /* EVE_FLASHFS_H_ */
@@ -0,0 +1,94 @@
+/*
+@file    EVE_fonts.c
+@brief   loads a custom font generated by tools/eve_font to RAM_G and registers it with the co-processor
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+eve_font rasterizes the characters a font needs to L1, L2, L4 or L8 glyphs and writes the font metric block
+with the glyphs right behind it, deflated by default.
+EVE_font_load() does everything it takes to use the font, it inflates or writes the data to address,
+sets the address of the glyphs in the metric block to where these ended up and registers the font
+with EVE_cmd_setfont2(), or with EVE_cmd_setfont() for FT80x.
+So the same data can be loaded to any address that is 4-byte aligned.
+
+eve_font -n dialog -p 24 -f L4 -s tft.c DejaVuSans.ttf
+
+EVE_font_load(12, MEM_FONT, dialog, DIALOG_LENGTH, DIALOG_FIRSTCHAR);
+EVE_metrics_font(12, MEM_FONT);
+...
+EVE_cmd_text(10, 10, 12, 0, "Settings");
+
+The metric block starts with the width of character 0 which always is 0 and a zlib stream for CMD_INFLATE starts with 0x78,
+so EVE_font_load() tells from the first byte if the data needs to be inflated.
+The glyphs follow each other from firstchar on, FT80x does not have EVE_cmd_setfont2(), so the address in the metric block
+is moved back by the glyphs of the characters before firstchar for EVE_cmd_setfont(), this needs address to be large enough.
+This is meant to be called outside display-list building, it includes executing the commands and waiting for completion, does not support cmd-burst.
+
+@section History
+
+4.1
+- first version
+- the minimum length only applies to fonts that are not deflated
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_target.h"
+#include "EVE_fonts.h"
+
+
+#define EVE_FONTS_BLOCK 61440UL /* bytes passed to block_transfer() at once, a multiple of 3840 */
+
+
+/* returns 0 when the data is not a font or address is not 4-byte aligned */
+uint8_t EVE_font_load(uint8_t font, uint32_t address, const uint8_t *data, uint32_t length, uint8_t firstchar)
+{
+	uint32_t done, block, glyphs;
+
+	if((length == 0) || ((address & 3) != 0) || (font > 31) || (firstchar > 127))
+	{
+		return 0;
+	}
+
+	if(fetch_flash_byte(data) == 0x78) /* a zlib stream can be shorter than the metric block it inflates to */
+	{
+		EVE_cmd_inflate(address, 0, 0);
+
+		for(done = 0; done < length; done += block)
+		{
+			block = ((length - done) < EVE_FONTS_BLOCK) ? (length - done) : EVE_FONTS_BLOCK;
+			block_transfer(&data[done], (uint16_t) block);
+		}
+	}
+	else
+	{
+		if(length <= EVE_FONT_TABLE_SIZE)
+		{
+			return 0;
+		}
+
+		for(done = 0; done < length; done += block)
+		{
+			block = ((length - done) < EVE_FONTS_BLOCK) ? (length - done) : EVE_FONTS_BLOCK;
+			EVE_memWrite_flash_buffer(address + done, &data[done], (uint16_t) block);
+		}
+	}
+
+	glyphs = address + EVE_FONT_TABLE_SIZE;
+
+	#if defined (FT81X_ENABLE)
+	EVE_memWrite32(address + EVE_FONTS_GPTR, glyphs);
+	EVE_cmd_setfont2(font, address, firstchar);
+	#else
+	/* the stride and the height are right in front of the address of the glyphs */
+	glyphs -= firstchar * EVE_memRead32(address + EVE_FONTS_GPTR - 12) * EVE_memRead32(address + EVE_FONTS_GPTR - 4);
+	EVE_memWrite32(address + EVE_FONTS_GPTR, glyphs);
+	EVE_cmd_setfont(font, address);
+	#endif
+
+	EVE_cmd_execute();
+	return 1;
+}
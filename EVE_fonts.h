@@ -0,0 +1,22 @@
+/*
+@file    EVE_fonts.h
+@brief   prototypes for loading the custom fonts generated by tools/eve_font
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_FONTS_H_
+#define EVE_FONTS_H_
+
+#define EVE_FONTS_GPTR 144	/* offset of the address of the glyphs in the font metric block */
+
+uint8_t EVE_font_load(uint8_t font, uint32_t address, const uint8_t *data, uint32_t length, uint8_t firstchar);
+
+#endif /* EVE_FONTS_H_ */
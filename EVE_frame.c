@@ -0,0 +1,232 @@
+/*
+@file    EVE_frame.c
+@brief   frame pacing, one display-list for every N refreshes of the panel
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+Driving the display-list updates from a timer of the host has no relation to the refresh of the panel,
+sometimes two lists are build for the same refresh and one of them is never shown, sometimes a refresh is skipped.
+The functions here use REG_FRAMES and REG_CLOCK of EVE to find out when the next refresh starts
+and tell when to start building the next list so that it completes just before the refresh it is meant for.
+A list that completes while the refresh before its deadline is running is shown at the deadline since CMD_SWAP
+waits for the end of the frame, so a list is never started before the previous one is on screen.
+
+EVE_frame_init(2); // new list every second refresh
+
+while(1)
+{
+	if(EVE_frame_due())
+	{
+		TFT_display(); // build the list, end it with CMD_SWAP and EVE_cmd_start()
+	}
+	else
+	{
+		TFT_touch(); // everything else
+	}
+}
+
+EVE_frame_due() reads two registers on every call and must not be called during a cmd-burst.
+The time for one refresh is calculated from EVE_HCYCLE, EVE_VCYCLE and EVE_PCLK in EVE_config.h.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_frame.h"
+
+
+static uint8_t frame_interval = 1;
+static uint32_t ticks_per_us = 60;		/* REG_CLOCK ticks per us */
+static uint32_t frame_period = 0;		/* REG_CLOCK ticks per refresh */
+static uint32_t frame_last = 0;			/* last value read from REG_FRAMES */
+static uint32_t frame_boundary = 0;		/* estimated REG_CLOCK value at the start of refresh frame_last */
+static uint32_t frame_target = 0;		/* refresh the next list is meant for */
+static uint32_t frame_deadline = 0;		/* REG_CLOCK value at the start of the target refresh of the list in flight */
+static uint32_t frame_started = 0;		/* REG_CLOCK value when the list in flight was started */
+static uint32_t frame_build = 0;		/* estimated build-time in ticks */
+static uint8_t frame_in_flight = 0;
+
+static EVE_frame_stats_t frame_stats;
+
+
+void EVE_frame_stats_reset(void)
+{
+	frame_stats.lists = 0;
+	frame_stats.missed = 0;
+	frame_stats.slack_min = 0x7FFFFFFFL;
+	frame_stats.slack_max = -0x7FFFFFFFL;
+	frame_stats.slack_avg = 0;
+}
+
+
+/* interval is the number of refreshes per display-list, this is meant to be called outside display-list building */
+void EVE_frame_init(uint8_t interval)
+{
+	uint32_t frames;
+
+	if(interval == 0)
+	{
+		interval = 1;
+	}
+
+	frame_interval = interval;
+	ticks_per_us = EVE_memRead32(REG_FREQUENCY) / 1000000UL;
+
+	if(ticks_per_us == 0)
+	{
+		ticks_per_us = 1;
+	}
+
+	frame_period = (uint32_t) EVE_HCYCLE * EVE_VCYCLE * EVE_PCLK;
+	frame_build = frame_period / 2;
+	frame_in_flight = 0;
+
+	/* sync to the start of a refresh */
+	frames = EVE_memRead32(REG_FRAMES);
+	do
+	{
+		frame_last = EVE_memRead32(REG_FRAMES);
+	} while(frame_last == frames);
+
+	frame_boundary = EVE_memRead32(REG_CLOCK);
+	frame_target = frame_last + 1;
+
+	EVE_frame_stats_reset();
+}
+
+
+static void EVE_frame_sync(uint32_t frames, uint32_t now)
+{
+	uint32_t predicted;
+
+	if(frames == frame_last)
+	{
+		return;
+	}
+
+	/* the change is seen when REG_FRAMES is polled, the real start of the refresh can only be earlier */
+	predicted = frame_boundary + ((frames - frame_last) * frame_period);
+
+	if(((int32_t) (now - predicted) < 0) || ((now - predicted) > frame_period))
+	{
+		predicted = now;
+	}
+
+	frame_boundary = predicted;
+	frame_last = frames;
+}
+
+
+static void EVE_frame_complete(uint32_t now)
+{
+	int32_t slack;
+	uint32_t build;
+
+	frame_in_flight = 0;
+
+	build = now - frame_started;
+	if(build > frame_build)
+	{
+		frame_build = build; /* follow up fast */
+	}
+	else
+	{
+		frame_build -= (frame_build - build) / 64; /* and down slow */
+	}
+
+	slack = ((int32_t) (frame_deadline - now)) / (int32_t) ticks_per_us;
+
+	if(slack < 0)
+	{
+		frame_stats.missed++;
+	}
+
+	if(slack < frame_stats.slack_min)
+	{
+		frame_stats.slack_min = slack;
+	}
+
+	if(slack > frame_stats.slack_max)
+	{
+		frame_stats.slack_max = slack;
+	}
+
+	if(frame_stats.lists == 1)
+	{
+		frame_stats.slack_avg = slack;
+	}
+	else
+	{
+		frame_stats.slack_avg += (slack - frame_stats.slack_avg) / 16;
+	}
+}
+
+
+/* returns 1 when it is time to start building the next display-list */
+uint8_t EVE_frame_due(void)
+{
+	uint32_t now;
+	uint32_t frames;
+	uint32_t deadline;
+
+	frames = EVE_memRead32(REG_FRAMES);
+	now = EVE_memRead32(REG_CLOCK);
+	EVE_frame_sync(frames, now);
+
+	if(frame_in_flight)
+	{
+		if(EVE_busy())
+		{
+			return 0;
+		}
+
+		EVE_frame_complete(now);
+	}
+
+	if((int32_t) (frame_last - frame_target) >= 0) /* too late for that one already */
+	{
+		frame_target = frame_last + 1;
+	}
+
+	if((frame_target - frame_last) > 1) /* the previous list still needs to be shown */
+	{
+		return 0;
+	}
+
+	deadline = frame_boundary + frame_period;
+
+	if((int32_t) (deadline - now) > (int32_t) (frame_build + (EVE_FRAME_MARGIN_US * ticks_per_us)))
+	{
+		return 0;
+	}
+
+	frame_deadline = deadline;
+	frame_started = now;
+	frame_target += frame_interval;
+	frame_in_flight = 1;
+	frame_stats.lists++;
+	return 1;
+}
+
+
+void EVE_frame_report(EVE_frame_stats_t *stats)
+{
+	*stats = frame_stats;
+
+	if(stats->lists == 0)
+	{
+		stats->slack_min = 0;
+		stats->slack_max = 0;
+	}
+
+	stats->jitter = (uint32_t) (stats->slack_max - stats->slack_min);
+	stats->build_time = frame_build / ticks_per_us;
+	stats->frame_time = frame_period / ticks_per_us;
+}
@@ -0,0 +1,37 @@
+/*
+@file    EVE_frame.h
+@brief   prototypes for the frame pacing scheduler
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_FRAME_H_
+#define EVE_FRAME_H_
+
+#define EVE_FRAME_MARGIN_US 300	/* safety margin in us added to the estimated build-time */
+
+typedef struct
+{
+	uint32_t lists;			/* lists that were started since the last reset of the statistics */
+	uint32_t missed;		/* lists that were not complete before the refresh they were meant for */
+	int32_t slack_min;		/* time in us between completion of a list and its deadline, negative when late */
+	int32_t slack_max;
+	int32_t slack_avg;		/* running average */
+	uint32_t jitter;		/* slack_max - slack_min */
+	uint32_t build_time;	/* current estimate in us from EVE_frame_due() returning 1 to completion of the list */
+	uint32_t frame_time;	/* in us, the time for one refresh of the panel */
+} EVE_frame_stats_t;
+
+void EVE_frame_init(uint8_t interval);
+uint8_t EVE_frame_due(void);
+void EVE_frame_report(EVE_frame_stats_t *stats);
+void EVE_frame_stats_reset(void);
+
+#endif /* EVE_FRAME_H_ */
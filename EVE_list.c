@@ -0,0 +1,295 @@
+/*
+@file    EVE_list.c
+@brief   scrolling list for large data sets that only draws the rows that are visible
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+The list only asks for the rows that are inside its area, so the cost for a frame depends on the height of the area
+and not on the number of rows.
+On FT81x and BT81x each row is drawn with its top at y0 = 0 and moved to its place with VERTEX_TRANSLATE_Y,
+so the display-list of a row does not depend on the scroll offset. After a row was drawn once
+EVE_list_update() captures it into a slot in RAM_G, from then on it is added with CMD_APPEND while it is visible.
+The slot of a row is row % slots, rows that scroll out of view release their slot to the rows that scroll in.
+FT80x has no VERTEX_TRANSLATE_Y, the rows are always drawn directly at their position.
+
+static void draw_row(uint32_t row, int16_t y0)
+{
+	EVE_cmd_text(10, y0 + 4, 26, 0, log_line(row));
+}
+
+EVE_list_t log = {0, 40, EVE_HSIZE, EVE_VSIZE - 40, 24, 10, draw_row};
+
+EVE_segment_pool(MEM_SEGMENTS, 32768);
+EVE_list_init(&log, 16, 512);
+EVE_list_rows(&log, 5000);
+EVE_list_track(&log);
+
+and for every frame:
+EVE_list_tracker(&log, EVE_memRead32(REG_TRACKER));
+...
+EVE_list_draw(&log);
+...
+EVE_cmd_execute();
+EVE_list_update(&log);
+
+The rows are drawn with the tag of the list, the whole area is covered with an invisible rectangle
+with that tag so that it can be touched anywhere. Scrolling by touch uses the changes of the value
+of the vertical tracker that EVE_list_track() sets up, EVE_list_scroll() is for everything else.
+When the data of a row changes it needs to be released with EVE_list_invalidate_row() to be drawn again.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+#include "EVE_list.h"
+
+
+#define EVE_LIST_EMPTY		0
+#define EVE_LIST_PENDING	1	/* waiting to be captured by EVE_list_update() */
+#define EVE_LIST_VALID		2
+#define EVE_LIST_TOO_BIG	3	/* does not fit into a slot, always drawn directly */
+
+
+/* slots is the number of rows kept in RAM_G, it should be more than the number of rows that are visible */
+/* slot is the space for a single row, returns 0 if there is not enough space left in the segment pool or on FT80x */
+uint8_t EVE_list_init(EVE_list_t *list, uint8_t slots, uint16_t slot)
+{
+	if(slots > EVE_LIST_SLOTS)
+	{
+		slots = EVE_LIST_SLOTS;
+	}
+
+#if !defined (FT81X_ENABLE)
+	slots = 0; /* the rows are not kept without VERTEX_TRANSLATE_Y */
+#endif
+
+	list->slot = (slot + 3) & ~3U;
+	list->slots = slots;
+	list->start = EVE_segment_alloc((uint32_t) slots * list->slot);
+	list->offset = 0;
+	list->track = 0;
+	list->touched = 0;
+
+	if(list->start == EVE_SEGMENT_NONE)
+	{
+		list->slots = 0;
+	}
+
+	EVE_list_invalidate(list);
+	return (list->slots != 0) ? 1 : 0;
+}
+
+
+/* set the size of the data set, the rows that are in RAM_G are kept */
+void EVE_list_rows(EVE_list_t *list, uint32_t rows)
+{
+	list->rows = rows;
+	EVE_list_set_offset(list, list->offset);
+}
+
+
+/* release all rows, for example when the data set was replaced */
+void EVE_list_invalidate(EVE_list_t *list)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_LIST_SLOTS; index++)
+	{
+		list->row[index] = EVE_LIST_NONE;
+		list->num[index] = 0;
+		list->state[index] = EVE_LIST_EMPTY;
+	}
+}
+
+
+void EVE_list_invalidate_row(EVE_list_t *list, uint32_t row)
+{
+	uint8_t index;
+
+	if(list->slots != 0)
+	{
+		index = (uint8_t) (row % list->slots);
+
+		if(list->row[index] == row)
+		{
+			list->row[index] = EVE_LIST_NONE;
+			list->state[index] = EVE_LIST_EMPTY;
+		}
+	}
+}
+
+
+/* the offset is the number of pixels the list is scrolled down, it is limited to the height of the data set */
+void EVE_list_set_offset(EVE_list_t *list, int32_t offset)
+{
+	int32_t limit;
+
+	limit = ((int32_t) list->rows * list->row_height) - list->h0;
+
+	if(offset > limit)
+	{
+		offset = limit;
+	}
+
+	if(offset < 0)
+	{
+		offset = 0;
+	}
+
+	list->offset = offset;
+}
+
+
+void EVE_list_scroll(EVE_list_t *list, int32_t delta)
+{
+	EVE_list_set_offset(list, list->offset + delta);
+}
+
+
+/* set up a vertical tracker over the area of the list, REG_TRACKER then reports the touch position along it */
+void EVE_list_track(const EVE_list_t *list)
+{
+	EVE_cmd_track(list->x0, list->y0, 1, list->h0, list->tag);
+}
+
+
+/* scroll the list by the distance the touch moved since the last frame, tracker is the value of REG_TRACKER */
+void EVE_list_tracker(EVE_list_t *list, uint32_t tracker)
+{
+	int32_t position;
+
+	if((list->tag == 0) || ((tracker & 0xff) != list->tag))
+	{
+		list->touched = 0;
+		return;
+	}
+
+	position = (int32_t) (((tracker >> 16) * list->h0) >> 16);
+
+	if(list->touched)
+	{
+		EVE_list_scroll(list, list->track - position);
+	}
+
+	list->track = position;
+	list->touched = 1;
+}
+
+
+/* add the visible rows to the display-list that currently is build */
+void EVE_list_draw(EVE_list_t *list)
+{
+	uint32_t row;
+	uint32_t last;
+	int16_t ypos;
+#if defined (FT81X_ENABLE)
+	uint32_t owner;
+	uint8_t index;
+#endif
+
+	row = (uint32_t) list->offset / list->row_height;
+	last = (uint32_t) (list->offset + list->h0 - 1) / list->row_height;
+	ypos = list->y0 - (int16_t) ((uint32_t) list->offset % list->row_height);
+
+	EVE_cmd_dl(DL_SAVE_CONTEXT);
+	EVE_cmd_dl(SCISSOR_XY(list->x0, list->y0));
+	EVE_cmd_dl(SCISSOR_SIZE(list->w0, list->h0));
+
+	if(list->tag != 0)
+	{
+		EVE_cmd_dl(TAG(list->tag));
+		EVE_cmd_dl(DL_SAVE_CONTEXT);
+#if defined (FT81X_ENABLE)
+		EVE_cmd_dl(VERTEX_FORMAT(4)); /* the application might use a different one */
+#endif
+		EVE_cmd_dl(COLOR_MASK(0, 0, 0, 0));
+		EVE_cmd_dl(DL_BEGIN | EVE_RECTS);
+		EVE_cmd_dl(VERTEX2F(list->x0 * 16, list->y0 * 16));
+		EVE_cmd_dl(VERTEX2F((list->x0 + list->w0 - 1) * 16, (list->y0 + list->h0 - 1) * 16));
+		EVE_cmd_dl(DL_END);
+		EVE_cmd_dl(DL_RESTORE_CONTEXT);
+	}
+
+	for(; (row <= last) && (row < list->rows); row++)
+	{
+#if defined (FT81X_ENABLE)
+		EVE_cmd_dl(VERTEX_TRANSLATE_Y((uint32_t) ((int32_t) ypos * 16)));
+
+		if(list->slots == 0)
+		{
+			list->draw_row(row, 0);
+		}
+		else
+		{
+			index = (uint8_t) (row % list->slots);
+			owner = list->row[index];
+
+			if((owner == row) && (list->state[index] == EVE_LIST_VALID))
+			{
+				EVE_cmd_append(list->start + ((uint32_t) index * list->slot), list->num[index]);
+			}
+			else
+			{
+				/* a slot that belongs to another visible row is not taken, that row would lose it again in the same frame */
+				if((owner != row) && ((owner == EVE_LIST_NONE) || (owner < ((uint32_t) list->offset / list->row_height)) || (owner > last)))
+				{
+					list->row[index] = row;
+					list->state[index] = EVE_LIST_PENDING;
+				}
+
+				list->draw_row(row, 0);
+			}
+		}
+#else
+		list->draw_row(row, ypos);
+#endif
+		ypos += list->row_height;
+	}
+
+	EVE_cmd_dl(DL_RESTORE_CONTEXT);
+}
+
+
+/* capture the rows that were drawn directly in the last frame, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_list_update(EVE_list_t *list)
+{
+	uint16_t num;
+	uint8_t index;
+	uint8_t captured = 0;
+
+	for(index = 0; index < list->slots; index++)
+	{
+		if(list->state[index] == EVE_LIST_PENDING)
+		{
+			EVE_segment_start();
+			list->draw_row(list->row[index], 0);
+			num = EVE_segment_length();
+
+			if(num <= list->slot)
+			{
+				EVE_cmd_memcpy(list->start + ((uint32_t) index * list->slot), EVE_RAM_DL, num);
+				list->num[index] = num;
+				list->state[index] = EVE_LIST_VALID;
+			}
+			else
+			{
+				list->state[index] = EVE_LIST_TOO_BIG;
+			}
+
+			captured = 1;
+		}
+	}
+
+	if(captured)
+	{
+		EVE_cmd_execute();
+	}
+}
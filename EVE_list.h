@@ -0,0 +1,53 @@
+/*
+@file    EVE_list.h
+@brief   prototypes for the scrolling list that only draws the visible rows
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_LIST_H_
+#define EVE_LIST_H_
+
+#define EVE_LIST_SLOTS 32	/* maximum number of rows that are kept in RAM_G for a list */
+#define EVE_LIST_NONE 0xFFFFFFFFUL
+
+typedef struct
+{
+	int16_t x0;		/* area on the screen, rows are clipped to it */
+	int16_t y0;
+	uint16_t w0;
+	uint16_t h0;
+	uint16_t row_height;
+	uint8_t tag;	/* tag for touch and CMD_TRACK, 0 if the list is not scrolled by touch */
+	void (*draw_row)(uint32_t row, int16_t y0);	/* draws a row with its top at y0 */
+	uint32_t rows;	/* the size of the data set, set with EVE_list_rows() */
+	int32_t offset;	/* the rest is managed by EVE_list.c */
+	int32_t track;
+	uint32_t start;
+	uint16_t slot;
+	uint8_t slots;
+	uint8_t touched;
+	uint32_t row[EVE_LIST_SLOTS];	/* the row a slot belongs to */
+	uint16_t num[EVE_LIST_SLOTS];	/* length of the captured display-list, 0 if there is none yet */
+	uint8_t state[EVE_LIST_SLOTS];
+} EVE_list_t;
+
+uint8_t EVE_list_init(EVE_list_t *list, uint8_t slots, uint16_t slot);
+void EVE_list_rows(EVE_list_t *list, uint32_t rows);
+void EVE_list_invalidate(EVE_list_t *list);
+void EVE_list_invalidate_row(EVE_list_t *list, uint32_t row);
+void EVE_list_scroll(EVE_list_t *list, int32_t delta);
+void EVE_list_set_offset(EVE_list_t *list, int32_t offset);
+void EVE_list_track(const EVE_list_t *list);
+void EVE_list_tracker(EVE_list_t *list, uint32_t tracker);
+void EVE_list_draw(EVE_list_t *list);
+void EVE_list_update(EVE_list_t *list);
+
+#endif /* EVE_LIST_H_ */
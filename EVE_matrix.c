@@ -0,0 +1,248 @@
+/*
+@file    EVE_matrix.c
+@brief   host-side bitmap transform matrix, fixed-point
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+Rotating or scaling a bitmap with CMD_LOADIDENTITY, CMD_TRANSLATE, CMD_ROTATE, CMD_SCALE and CMD_SETMATRIX
+has the co-processor do the trigonometry and the matrix multiplications, for every bitmap in every frame.
+The functions here do the same on the host in 16.16 fixed-point and put BITMAP_TRANSFORM_A...F into the display-list directly.
+The transformations are applied in the same order and with the same units as the co-processor commands so
+
+EVE_cmd_dl(CMD_LOADIDENTITY);
+EVE_cmd_translate(65536 * 70, 65536 * 50);
+EVE_cmd_rotate(rotate);
+EVE_cmd_translate(65536 * -70, 65536 * -50);
+EVE_cmd_dl(CMD_SETMATRIX);
+
+becomes
+
+EVE_matrix_identity(&matrix);
+EVE_matrix_translate(&matrix, 65536 * 70, 65536 * 50);
+EVE_matrix_rotate(&matrix, rotate);
+EVE_matrix_translate(&matrix, 65536 * -70, 65536 * -50);
+EVE_cmd_matrix(&matrix);
+
+or with EVE_cmd_rotation(&icon, 70, 50, rotate, 65536) which only calculates anything when the values changed.
+With BT81X_ENABLE the _EXT forms with 1.15 precision are used for A, B, D and E when the values are small enough.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_matrix.h"
+
+
+/* Taylor series for sin(x * pi/2), x = 0...1, coefficients in 2.30 */
+#define EVE_SIN_K1 1686629713LL
+#define EVE_SIN_K3 693598668LL
+#define EVE_SIN_K5 85569306LL
+#define EVE_SIN_K7 5026995LL
+#define EVE_SIN_K9 172272LL
+
+/* sine in 16.16, angle is in 1/65536 of a circle like for CMD_ROTATE */
+int32_t EVE_sin16(int32_t angle)
+{
+	int64_t x, x2, r;
+	uint8_t quadrant;
+
+	angle &= 0xffff;
+	quadrant = (uint8_t) (angle >> 14);
+	x = angle & 0x3fff;
+
+	if(quadrant & 1)
+	{
+		x = 0x4000 - x;
+	}
+
+	x <<= 16; /* 0...1 in 2.30 */
+	x2 = (x * x) >> 30;
+
+	r = EVE_SIN_K9;
+	r = EVE_SIN_K7 - ((r * x2) >> 30);
+	r = EVE_SIN_K5 - ((r * x2) >> 30);
+	r = EVE_SIN_K3 - ((r * x2) >> 30);
+	r = EVE_SIN_K1 - ((r * x2) >> 30);
+	r = (r * x) >> 30;
+
+	r = (r + (1 << 13)) >> 14; /* 2.30 to 16.16 */
+
+	if(quadrant & 2)
+	{
+		r = -r;
+	}
+
+	return (int32_t) r;
+}
+
+
+int32_t EVE_cos16(int32_t angle)
+{
+	return EVE_sin16(angle + 0x4000);
+}
+
+
+static int32_t EVE_mul16(int32_t a, int32_t b)
+{
+	return (int32_t) (((int64_t) a * b) >> 16);
+}
+
+
+void EVE_matrix_identity(EVE_matrix_t *m)
+{
+	m->a = 65536;
+	m->b = 0;
+	m->c = 0;
+	m->d = 0;
+	m->e = 65536;
+	m->f = 0;
+}
+
+
+/* tx and ty are in 16.16 pixels like for CMD_TRANSLATE */
+void EVE_matrix_translate(EVE_matrix_t *m, int32_t tx, int32_t ty)
+{
+	m->c -= tx;
+	m->f -= ty;
+}
+
+
+/* sx and sy are 16.16 like for CMD_SCALE, 0 is ignored */
+void EVE_matrix_scale(EVE_matrix_t *m, int32_t sx, int32_t sy)
+{
+	int32_t inverse;
+
+	if(sx != 0)
+	{
+		inverse = (int32_t) (((int64_t) 1 << 32) / sx);
+		m->a = EVE_mul16(m->a, inverse);
+		m->b = EVE_mul16(m->b, inverse);
+		m->c = EVE_mul16(m->c, inverse);
+	}
+
+	if(sy != 0)
+	{
+		inverse = (int32_t) (((int64_t) 1 << 32) / sy);
+		m->d = EVE_mul16(m->d, inverse);
+		m->e = EVE_mul16(m->e, inverse);
+		m->f = EVE_mul16(m->f, inverse);
+	}
+}
+
+
+/* clockwise rotation, angle is in 1/65536 of a circle like for CMD_ROTATE */
+void EVE_matrix_rotate(EVE_matrix_t *m, int32_t angle)
+{
+	int32_t sine, cosine;
+	int32_t a, b, c;
+
+	sine = EVE_sin16(angle);
+	cosine = EVE_cos16(angle);
+
+	a = m->a;
+	b = m->b;
+	c = m->c;
+
+	m->a = EVE_mul16(cosine, a) + EVE_mul16(sine, m->d);
+	m->b = EVE_mul16(cosine, b) + EVE_mul16(sine, m->e);
+	m->c = EVE_mul16(cosine, c) + EVE_mul16(sine, m->f);
+	m->d = EVE_mul16(cosine, m->d) - EVE_mul16(sine, a);
+	m->e = EVE_mul16(cosine, m->e) - EVE_mul16(sine, b);
+	m->f = EVE_mul16(cosine, m->f) - EVE_mul16(sine, c);
+}
+
+
+/* 16.16 to the 17 bit values for BITMAP_TRANSFORM_A, B, D and E, precision is set to 1 for 1.15 and to 0 for 8.8 */
+static int32_t EVE_matrix_coefficient(int32_t value, uint8_t *precision)
+{
+	#if defined (BT81X_ENABLE)
+	if((value >= -131072L) && (value < 131071L)) /* fits into 1.15, also after rounding */
+	{
+		*precision = 1;
+		return (value + 1) >> 1;
+	}
+	#endif
+
+	*precision = 0;
+	return (value + 128) >> 8;
+}
+
+
+/* convert to the six display-list commands BITMAP_TRANSFORM_A...F */
+void EVE_matrix_transform(const EVE_matrix_t *m, uint32_t *transform)
+{
+	uint8_t pa, pb, pd, pe;
+	int32_t a, b, d, e;
+
+	a = EVE_matrix_coefficient(m->a, &pa);
+	b = EVE_matrix_coefficient(m->b, &pb);
+	d = EVE_matrix_coefficient(m->d, &pd);
+	e = EVE_matrix_coefficient(m->e, &pe);
+
+	#if defined (BT81X_ENABLE)
+	transform[0] = BITMAP_TRANSFORM_A_EXT(pa, a);
+	transform[1] = BITMAP_TRANSFORM_B_EXT(pb, b);
+	transform[3] = BITMAP_TRANSFORM_D_EXT(pd, d);
+	transform[4] = BITMAP_TRANSFORM_E_EXT(pe, e);
+	#else
+	transform[0] = BITMAP_TRANSFORM_A(a);
+	transform[1] = BITMAP_TRANSFORM_B(b);
+	transform[3] = BITMAP_TRANSFORM_D(d);
+	transform[4] = BITMAP_TRANSFORM_E(e);
+	#endif
+
+	transform[2] = BITMAP_TRANSFORM_C((m->c + 128) >> 8);
+	transform[5] = BITMAP_TRANSFORM_F((m->f + 128) >> 8);
+}
+
+
+void EVE_cmd_matrix(const EVE_matrix_t *m)
+{
+	uint32_t transform[6];
+	uint8_t index;
+
+	EVE_matrix_transform(m, transform);
+
+	for(index = 0; index < 6; index++)
+	{
+		EVE_cmd_dl(transform[index]);
+	}
+}
+
+
+/* rotate and scale around x0 / y0 of the bitmap like CMD_ROTATEAROUND, scale is 16.16, the matrix is only calculated when anything changed */
+void EVE_cmd_rotation(EVE_rotation_t *rotation, int16_t x0, int16_t y0, int32_t angle, int32_t scale)
+{
+	EVE_matrix_t m;
+	uint8_t index;
+
+	angle &= 0xffff;
+
+	if((rotation->valid == 0) || (rotation->angle != angle) || (rotation->scale != scale) || (rotation->x0 != x0) || (rotation->y0 != y0))
+	{
+		EVE_matrix_identity(&m);
+		EVE_matrix_translate(&m, (int32_t) x0 * 65536, (int32_t) y0 * 65536);
+		EVE_matrix_rotate(&m, angle);
+		EVE_matrix_scale(&m, scale, scale);
+		EVE_matrix_translate(&m, (int32_t) x0 * -65536, (int32_t) y0 * -65536);
+		EVE_matrix_transform(&m, rotation->transform);
+
+		rotation->angle = angle;
+		rotation->scale = scale;
+		rotation->x0 = x0;
+		rotation->y0 = y0;
+		rotation->valid = 1;
+	}
+
+	for(index = 0; index < 6; index++)
+	{
+		EVE_cmd_dl(rotation->transform[index]);
+	}
+}
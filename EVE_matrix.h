@@ -0,0 +1,51 @@
+/*
+@file    EVE_matrix.h
+@brief   prototypes for the host-side bitmap transform matrix
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_MATRIX_H_
+#define EVE_MATRIX_H_
+
+/* 16.16 fixed-point, same layout as the co-processor matrix, maps screen coordinates to bitmap coordinates */
+typedef struct
+{
+	int32_t a;
+	int32_t b;
+	int32_t c;
+	int32_t d;
+	int32_t e;
+	int32_t f;
+} EVE_matrix_t;
+
+/* a rotation around a point of the bitmap with the result cached */
+typedef struct
+{
+	uint32_t transform[6];	/* BITMAP_TRANSFORM_A...F */
+	int32_t angle;
+	int32_t scale;
+	int16_t x0;
+	int16_t y0;
+	uint8_t valid;
+} EVE_rotation_t;
+
+int32_t EVE_sin16(int32_t angle);
+int32_t EVE_cos16(int32_t angle);
+
+void EVE_matrix_identity(EVE_matrix_t *m);
+void EVE_matrix_translate(EVE_matrix_t *m, int32_t tx, int32_t ty);
+void EVE_matrix_scale(EVE_matrix_t *m, int32_t sx, int32_t sy);
+void EVE_matrix_rotate(EVE_matrix_t *m, int32_t angle);
+void EVE_matrix_transform(const EVE_matrix_t *m, uint32_t *transform);
+void EVE_cmd_matrix(const EVE_matrix_t *m);
+void EVE_cmd_rotation(EVE_rotation_t *rotation, int16_t x0, int16_t y0, int32_t angle, int32_t scale);
+
+#endif /* EVE_MATRIX_H_ */
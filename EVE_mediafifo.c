@@ -0,0 +1,207 @@
+/*
+@file    EVE_mediafifo.c
+@brief   producer for the Media-FIFO, feeds a ring in RAM_G for EVE_OPT_MEDIAFIFO and CMD_VIDEOFRAME
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+EVE_cmd_mediafifo() only tells the co-processor where the ring is, this writes the data into it and moves REG_MEDIAFIFO_WRITE.
+Data is written in as large pieces as there is space for, followed by a single write to REG_MEDIAFIFO_WRITE.
+REG_MEDIAFIFO_READ is only read when the space that is known to be free is not enough for EVE_MEDIAFIFO_BURST bytes,
+as the co-processor only ever frees space the last value read is always on the safe side.
+Four bytes of the ring are always kept free so that a full ring can not be mistaken for an empty one.
+
+There are two ways to feed it, EVE_mediafifo_push() writes what fits of a buffer and returns how much that was,
+EVE_mediafifo_service() pulls data from a source function for as long as there is space.
+Either way this is meant to be called every time the main loop comes by while the co-processor is working,
+since it never waits, the loop can go on with touch, sensors and whatever else is going on.
+
+A JPEG of any size thru a 16k window:
+
+uint16_t read_jpeg(uint8_t *buffer, uint16_t size) { return fread(buffer, 1, size, jpeg_file); }
+
+EVE_mediafifo_init(&fifo, 0xFC000, 16384);
+EVE_mediafifo_source(&fifo, read_jpeg, buffer, sizeof(buffer));
+EVE_mediafifo_service(&fifo);
+EVE_cmd_loadimage(MEM_PIC, EVE_OPT_MEDIAFIFO | EVE_OPT_NODL, NULL, 0);
+EVE_cmd_start();
+
+while(EVE_busy())
+{
+	EVE_mediafifo_service(&fifo);
+	other_things();
+}
+
+A video decodes a frame at a time with EVE_cmd_videoframe(), the display-list of the frame is build after each frame was decoded.
+EVE_cmd_dl(CMD_VIDEOSTART) and EVE_cmd_videoframe() both read from the Media-FIFO, while the co-processor waits for data
+the previous display-list stays on the screen.
+
+The functions write to RAM_G directly, they are meant to be called outside display-list building, do not support cmd-burst.
+The Media-FIFO only exists with FT81x and BT81x.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_target.h"
+#include "EVE_mediafifo.h"
+
+#if defined (FT81X_ENABLE)
+
+/* sets up the ring and sends CMD_MEDIAFIFO, this executes the command to make sure the pointers are reset before data is written */
+void EVE_mediafifo_init(EVE_mediafifo_t *fifo, uint32_t base, uint32_t size)
+{
+	fifo->base = base;
+	fifo->size = size;
+	fifo->source = 0;
+	fifo->buffer = 0;
+	fifo->buffer_size = 0;
+	fifo->ended = 0;
+	fifo->write = 0;
+	fifo->read = 0;
+	fifo->total = 0;
+	fifo->polls = 0;
+
+	EVE_cmd_mediafifo(base, size);
+	EVE_cmd_execute();
+}
+
+
+/* source is called by EVE_mediafifo_service() with buffer to fill it with up to size bytes */
+void EVE_mediafifo_source(EVE_mediafifo_t *fifo, uint16_t (*source)(uint8_t *buffer, uint16_t size), uint8_t *buffer, uint16_t buffer_size)
+{
+	fifo->source = source;
+	fifo->buffer = buffer;
+	fifo->buffer_size = buffer_size;
+	fifo->ended = 0;
+}
+
+
+static uint32_t EVE_mediafifo_free(const EVE_mediafifo_t *fifo)
+{
+	uint32_t used;
+
+	used = (fifo->write >= fifo->read) ? (fifo->write - fifo->read) : (fifo->size - fifo->read + fifo->write);
+	return fifo->size - used - 4;
+}
+
+
+/* returns the free space, REG_MEDIAFIFO_READ is only read when less than wanted is known to be free */
+uint32_t EVE_mediafifo_space(EVE_mediafifo_t *fifo, uint32_t wanted)
+{
+	uint32_t space = EVE_mediafifo_free(fifo);
+
+	if(space < wanted)
+	{
+		fifo->read = EVE_memRead32(REG_MEDIAFIFO_READ);
+		fifo->polls++;
+		space = EVE_mediafifo_free(fifo);
+	}
+
+	return space;
+}
+
+
+/* writes as much of data as fits into the ring, returns the number of bytes written which can be 0 */
+uint32_t EVE_mediafifo_push(EVE_mediafifo_t *fifo, const uint8_t *data, uint32_t length)
+{
+	uint32_t space, count, chunk;
+
+	space = EVE_mediafifo_space(fifo, (length < EVE_MEDIAFIFO_BURST) ? length : EVE_MEDIAFIFO_BURST);
+
+	if(length > space)
+	{
+		length = space;
+	}
+
+	if(length == 0)
+	{
+		return 0;
+	}
+
+	#if defined (EVE_DMA)
+	while(EVE_dma_busy);
+	#endif
+
+	for(count = 0; count < length; count += chunk)
+	{
+		chunk = length - count;
+
+		if(chunk > (fifo->size - fifo->write)) /* up to the end of the ring */
+		{
+			chunk = fifo->size - fifo->write;
+		}
+
+		if(chunk > 0x8000)
+		{
+			chunk = 0x8000;
+		}
+
+		EVE_memWrite_sram_buffer(fifo->base + fifo->write, &data[count], (uint16_t) chunk);
+		fifo->write += chunk;
+
+		if(fifo->write == fifo->size)
+		{
+			fifo->write = 0;
+		}
+	}
+
+	EVE_memWrite32(REG_MEDIAFIFO_WRITE, fifo->write);
+	fifo->total += length;
+	return length;
+}
+
+
+/* fills the ring from the source, returns 0 once the source has ended */
+uint8_t EVE_mediafifo_service(EVE_mediafifo_t *fifo)
+{
+	uint32_t space;
+	uint16_t request, count;
+
+	if((fifo->source == 0) || (fifo->buffer_size == 0))
+	{
+		return 0;
+	}
+
+	if(fifo->ended == 0)
+	{
+		space = EVE_mediafifo_space(fifo, (fifo->buffer_size < EVE_MEDIAFIFO_BURST) ? fifo->buffer_size : EVE_MEDIAFIFO_BURST);
+
+		while(space != 0)
+		{
+			request = (space < fifo->buffer_size) ? (uint16_t) space : fifo->buffer_size;
+			count = fifo->source(fifo->buffer, request);
+
+			if(count == 0)
+			{
+				fifo->ended = 1;
+				break;
+			}
+
+			space -= EVE_mediafifo_push(fifo, fifo->buffer, (count < request) ? count : request);
+		}
+	}
+
+	return (fifo->ended == 0);
+}
+
+
+/* returns 1 when the co-processor has read everything that was written */
+uint8_t EVE_mediafifo_drained(EVE_mediafifo_t *fifo)
+{
+	if(fifo->read != fifo->write)
+	{
+		fifo->read = EVE_memRead32(REG_MEDIAFIFO_READ);
+		fifo->polls++;
+	}
+
+	return (fifo->read == fifo->write);
+}
+
+#endif /* FT81X_ENABLE */
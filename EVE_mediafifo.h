@@ -0,0 +1,47 @@
+/*
+@file    EVE_mediafifo.h
+@brief   prototypes for the producer that feeds the Media-FIFO
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_MEDIAFIFO_H_
+#define EVE_MEDIAFIFO_H_
+
+#if defined (FT81X_ENABLE)
+
+#if !defined (EVE_MEDIAFIFO_BURST)
+#define EVE_MEDIAFIFO_BURST 1024	/* REG_MEDIAFIFO_READ is only polled again when less than this fits into the FIFO */
+#endif
+
+typedef struct
+{
+	uint32_t base;	/* the ring in RAM_G, 4-byte aligned, the size a multiple of 4 */
+	uint32_t size;
+	uint16_t (*source)(uint8_t *buffer, uint16_t size);	/* for EVE_mediafifo_service(), returns the number of bytes put into buffer, 0 at the end */
+	uint8_t *buffer;
+	uint16_t buffer_size;
+	uint8_t ended;	/* the source returned 0 */
+	uint32_t write;	/* the rest is managed by EVE_mediafifo.c */
+	uint32_t read;
+	uint32_t total;	/* bytes written to the FIFO */
+	uint32_t polls;	/* reads of REG_MEDIAFIFO_READ */
+} EVE_mediafifo_t;
+
+void EVE_mediafifo_init(EVE_mediafifo_t *fifo, uint32_t base, uint32_t size);
+void EVE_mediafifo_source(EVE_mediafifo_t *fifo, uint16_t (*source)(uint8_t *buffer, uint16_t size), uint8_t *buffer, uint16_t buffer_size);
+uint32_t EVE_mediafifo_space(EVE_mediafifo_t *fifo, uint32_t wanted);
+uint32_t EVE_mediafifo_push(EVE_mediafifo_t *fifo, const uint8_t *data, uint32_t length);
+uint8_t EVE_mediafifo_service(EVE_mediafifo_t *fifo);
+uint8_t EVE_mediafifo_drained(EVE_mediafifo_t *fifo);
+
+#endif /* FT81X_ENABLE */
+
+#endif /* EVE_MEDIAFIFO_H_ */
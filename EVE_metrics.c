@@ -0,0 +1,343 @@
+/*
+@file    EVE_metrics.c
+@brief   host-side font metrics, measure text without co-processor commands
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+The widths of the characters and the height of a font are in the font metric block which is 148 bytes
+for every font, for the ROM fonts the blocks start at the address that is stored at EVE_ROM_FONT_ADDR.
+EVE_metrics_init() reads the blocks of the ROM fonts 16 to 31 once, custom fonts are added with EVE_metrics_font()
+and the same font and pointer that is used for EVE_cmd_setfont() or EVE_cmd_setfont2().
+After that all the functions that measure text work from the table on the host without any SPI traffic.
+
+EVE_metrics_init();
+EVE_cmd_setfont2(12, MEM_FONT, 32);
+EVE_metrics_font(12, MEM_FONT);
+...
+width = EVE_text_width(28, "Bytes: ");
+EVE_text_ellipsize(27, filename, 120, label, sizeof(label));
+
+The metric blocks only have widths for the first 128 characters, bit 7 is ignored.
+EVE_text_wrap() and EVE_text_lines() break lines at spaces and '\n' like EVE_OPT_FILL does.
+The functions that read from EVE are meant to be called outside display-list building, do not support cmd-burst.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_metrics.h"
+
+
+#define EVE_METRICS_HEIGHT 140	/* offset of the height in the font metric block */
+
+typedef struct
+{
+	uint8_t widths[EVE_NUMCHAR_PERFONT];
+	uint8_t height;
+} EVE_font_metrics_t;
+
+static EVE_font_metrics_t metrics[EVE_METRICS_FONTS];
+static uint8_t metrics_slot[32];	/* entry + 1 for every font, 0 when the font is not known */
+static uint8_t metrics_count = 0;
+
+
+/* copy the metric block at ptr to the table, returns 0 if the font is out of range or the table is full */
+static uint8_t EVE_metrics_read(int16_t font, uint32_t ptr)
+{
+	EVE_font_metrics_t *entry;
+	uint32_t data;
+	uint8_t slot;
+	uint8_t index;
+
+	if((font < 0) || (font > 31))
+	{
+		return 0;
+	}
+
+	slot = metrics_slot[font];
+
+	if(slot == 0)
+	{
+		if(metrics_count >= EVE_METRICS_FONTS)
+		{
+			return 0;
+		}
+
+		slot = ++metrics_count;
+	}
+
+	entry = &metrics[slot - 1];
+
+	for(index = 0; index < EVE_NUMCHAR_PERFONT; index += 4)
+	{
+		data = EVE_memRead32(ptr + index);
+		entry->widths[index] = (uint8_t) data;
+		entry->widths[index + 1] = (uint8_t) (data >> 8);
+		entry->widths[index + 2] = (uint8_t) (data >> 16);
+		entry->widths[index + 3] = (uint8_t) (data >> 24);
+	}
+
+	entry->height = (uint8_t) EVE_memRead32(ptr + EVE_METRICS_HEIGHT);
+	metrics_slot[font] = slot;
+	return 1;
+}
+
+
+/* forget all fonts and read the metrics of the ROM fonts 16 to 31 */
+void EVE_metrics_init(void)
+{
+	uint32_t ptr;
+	int16_t font;
+
+	memset(metrics_slot, 0, sizeof(metrics_slot));
+	metrics_count = 0;
+
+	ptr = EVE_memRead32(EVE_ROM_FONT_ADDR);
+
+	for(font = 16; font < 32; font++)
+	{
+		EVE_metrics_read(font, ptr);
+		ptr += EVE_FONT_TABLE_SIZE;
+	}
+}
+
+
+/* add a custom font, ptr is the address of its metric block as used with EVE_cmd_setfont() or EVE_cmd_setfont2() */
+uint8_t EVE_metrics_font(int16_t font, uint32_t ptr)
+{
+	return EVE_metrics_read(font, ptr);
+}
+
+
+#if defined (FT81X_ENABLE)
+/* the same as EVE_cmd_romfont(), the ROM fonts 32 to 34 follow the others in the ROM */
+uint8_t EVE_metrics_romfont(int16_t font, uint32_t romslot)
+{
+	uint32_t ptr;
+
+	if((romslot < 16) || (romslot > 34))
+	{
+		return 0;
+	}
+
+	ptr = EVE_memRead32(EVE_ROM_FONT_ADDR) + ((romslot - 16) * EVE_FONT_TABLE_SIZE);
+	return EVE_metrics_read(font, ptr);
+}
+#endif
+
+
+static const EVE_font_metrics_t *EVE_metrics_lookup(int16_t font)
+{
+	if((font < 0) || (font > 31) || (metrics_slot[font] == 0))
+	{
+		return 0;
+	}
+
+	return &metrics[metrics_slot[font] - 1];
+}
+
+
+/* returns 0 for fonts that are not in the table */
+uint16_t EVE_font_height(int16_t font)
+{
+	const EVE_font_metrics_t *entry = EVE_metrics_lookup(font);
+
+	return (entry != 0) ? entry->height : 0;
+}
+
+
+uint16_t EVE_char_width(int16_t font, char character)
+{
+	const EVE_font_metrics_t *entry = EVE_metrics_lookup(font);
+
+	return (entry != 0) ? entry->widths[(uint8_t) character & 0x7F] : 0;
+}
+
+
+/* the width of the first length characters of text */
+/* the four sums do not depend on each other, so the compiler is free to unroll and vectorize the loop */
+uint16_t EVE_text_width_n(int16_t font, const char* text, uint16_t length)
+{
+	const EVE_font_metrics_t *entry = EVE_metrics_lookup(font);
+	const uint8_t *widths;
+	const uint8_t *data = (const uint8_t *) text;
+	uint32_t sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+	if(entry == 0)
+	{
+		return 0;
+	}
+
+	widths = entry->widths;
+
+	while(length >= 4)
+	{
+		sum0 += widths[data[0] & 0x7F];
+		sum1 += widths[data[1] & 0x7F];
+		sum2 += widths[data[2] & 0x7F];
+		sum3 += widths[data[3] & 0x7F];
+		data += 4;
+		length -= 4;
+	}
+
+	while(length != 0)
+	{
+		sum0 += widths[*data & 0x7F];
+		data++;
+		length--;
+	}
+
+	sum0 += sum1 + sum2 + sum3;
+	return (sum0 > 0xFFFFUL) ? 0xFFFF : (uint16_t) sum0;
+}
+
+
+uint16_t EVE_text_width(int16_t font, const char* text)
+{
+	return EVE_text_width_n(font, text, (uint16_t) strlen(text));
+}
+
+
+/* returns how many characters of text fit into width */
+uint16_t EVE_text_fit(int16_t font, const char* text, uint16_t width)
+{
+	const EVE_font_metrics_t *entry = EVE_metrics_lookup(font);
+	uint32_t sum = 0;
+	uint16_t count = 0;
+
+	if(entry == 0)
+	{
+		return 0;
+	}
+
+	while(text[count] != 0)
+	{
+		sum += entry->widths[(uint8_t) text[count] & 0x7F];
+
+		if(sum > width)
+		{
+			break;
+		}
+
+		count++;
+	}
+
+	return count;
+}
+
+
+/* returns the number of characters in the first line when text is wrapped to width */
+/* lines are broken after the last space that fits or at '\n', a word that is wider than width is broken where it needs to be */
+uint16_t EVE_text_wrap(int16_t font, const char* text, uint16_t width)
+{
+	const EVE_font_metrics_t *entry = EVE_metrics_lookup(font);
+	uint32_t sum = 0;
+	uint16_t count = 0;
+	uint16_t space = 0;
+
+	if(entry == 0)
+	{
+		return (uint16_t) strlen(text);
+	}
+
+	while((text[count] != 0) && (text[count] != '\n'))
+	{
+		sum += entry->widths[(uint8_t) text[count] & 0x7F];
+
+		if(sum > width)
+		{
+			if(space != 0)
+			{
+				return space;
+			}
+
+			return (count != 0) ? count : 1; /* always make progress */
+		}
+
+		count++;
+
+		if(text[count - 1] == ' ')
+		{
+			space = count;
+		}
+	}
+
+	return count;
+}
+
+
+/* returns the number of lines text needs when it is wrapped to width, times EVE_font_height() is the height of the block */
+uint16_t EVE_text_lines(int16_t font, const char* text, uint16_t width)
+{
+	uint16_t lines = 0;
+
+	while(*text != 0)
+	{
+		text += EVE_text_wrap(font, text, width);
+
+		if(*text == '\n')
+		{
+			text++;
+		}
+
+		lines++;
+	}
+
+	return lines;
+}
+
+
+/* copy text to buffer, shortened to fit into width with "..." at the end when it is too wide, returns the width of the result */
+uint16_t EVE_text_ellipsize(int16_t font, const char* text, uint16_t width, char *buffer, uint16_t size)
+{
+	uint16_t dots;
+	uint16_t count;
+
+	if(size == 0)
+	{
+		return 0;
+	}
+
+	count = (uint16_t) strlen(text);
+
+	if(EVE_text_width_n(font, text, count) > width)
+	{
+		dots = 3 * EVE_char_width(font, '.');
+		count = (width > dots) ? EVE_text_fit(font, text, width - dots) : 0;
+
+		if(size < 4)
+		{
+			buffer[0] = 0;
+			return 0;
+		}
+
+		if(count > (size - 4))
+		{
+			count = size - 4;
+		}
+
+		memcpy(buffer, text, count);
+		memcpy(&buffer[count], "...", 4);
+	}
+	else
+	{
+		if(count > (size - 1))
+		{
+			count = size - 1;
+		}
+
+		memcpy(buffer, text, count);
+		buffer[count] = 0;
+	}
+
+	return EVE_text_width(font, buffer);
+}
@@ -0,0 +1,35 @@
+/*
+@file    EVE_metrics.h
+@brief   prototypes for the host-side font metrics
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_METRICS_H_
+#define EVE_METRICS_H_
+
+#define EVE_METRICS_FONTS 20	/* fonts in the table, the 16 ROM fonts plus the custom fonts */
+
+void EVE_metrics_init(void);
+uint8_t EVE_metrics_font(int16_t font, uint32_t ptr);
+#if defined (FT81X_ENABLE)
+uint8_t EVE_metrics_romfont(int16_t font, uint32_t romslot);
+#endif
+
+uint16_t EVE_font_height(int16_t font);
+uint16_t EVE_char_width(int16_t font, char character);
+uint16_t EVE_text_width(int16_t font, const char* text);
+uint16_t EVE_text_width_n(int16_t font, const char* text, uint16_t length);
+uint16_t EVE_text_fit(int16_t font, const char* text, uint16_t width);
+uint16_t EVE_text_wrap(int16_t font, const char* text, uint16_t width);
+uint16_t EVE_text_lines(int16_t font, const char* text, uint16_t width);
+uint16_t EVE_text_ellipsize(int16_t font, const char* text, uint16_t width, char *buffer, uint16_t size);
+
+#endif /* EVE_METRICS_H_ */
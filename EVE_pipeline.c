@@ -0,0 +1,335 @@
+/*
+@file    EVE_pipeline.c
+@brief   pipelined frame submission, the next frame is encoded while the co-processor still executes the previous one
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+With EVE_cmd_start() a frame is started without waiting for it but the next EVE_start_cmd_burst() needs the command-fifo
+again which at that time still is busy with the last frame.
+With EVE_PIPELINE enabled in EVE_config.h a frame can be encoded into a buffer in RAM instead, up to EVE_PIPE_DEPTH_MAX
+frames can be in the pipeline, a staged frame is written to the command-fifo as soon as there is space for it.
+The co-processor itself takes care that the CMD_DLSTART of a frame waits for the CMD_SWAP of the one before.
+
+EVE_pipe_init(2);
+
+while(1)
+{
+	if(EVE_pipe_begin())
+	{
+		EVE_cmd_dl(CMD_DLSTART);
+		...
+		EVE_cmd_dl(DL_DISPLAY);
+		EVE_cmd_dl(CMD_SWAP);
+		EVE_pipe_end();
+	}
+
+	EVE_pipe_commit();
+	...
+}
+
+Only functions that support cmd-burst can be used between EVE_pipe_begin() and EVE_pipe_end().
+Nothing else may write to the command-fifo while frames are in the pipeline, call EVE_pipe_flush() first.
+The latency of the stages is measured with REG_CLOCK, this costs a couple of register reads per frame.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_target.h"
+#include "EVE_pipeline.h"
+
+#if defined (EVE_PIPELINE)
+
+#define EVE_PIPE_FREE		0
+#define EVE_PIPE_ENCODING	1
+#define EVE_PIPE_STAGED		2	/* complete, waiting for space in the command-fifo */
+#define EVE_PIPE_RUNNING	3	/* written to the command-fifo */
+
+typedef struct
+{
+	uint8_t buffer[EVE_PIPE_BUFFER];
+	uint16_t length;
+	uint16_t offset;	/* position in the command-fifo */
+	uint32_t clock;		/* REG_CLOCK at the start of the current state */
+	uint8_t state;
+} EVE_pipe_stage_t;
+
+static EVE_pipe_stage_t pipe_stage[EVE_PIPE_DEPTH_MAX];
+static uint8_t pipe_depth = 2;
+static uint8_t pipe_head = 0;		/* stage for the next frame */
+static uint8_t pipe_tail = 0;		/* oldest frame in the pipeline */
+static uint8_t pipe_used = 0;
+static uint16_t pipe_write = 0;		/* offset in the command-fifo up to which frames were written */
+static uint32_t ticks_per_us = 60;
+
+static EVE_pipe_stats_t pipe_stats;
+
+
+void EVE_pipe_stats_reset(void)
+{
+	pipe_stats.frames = 0;
+	pipe_stats.dropped = 0;
+	pipe_stats.encode_avg = 0;
+	pipe_stats.encode_max = 0;
+	pipe_stats.queue_avg = 0;
+	pipe_stats.queue_max = 0;
+	pipe_stats.execute_avg = 0;
+	pipe_stats.execute_max = 0;
+}
+
+
+/* depth is the number of frames that can be in the pipeline at the same time, 2 or 3 */
+void EVE_pipe_init(uint8_t depth)
+{
+	uint8_t index;
+
+	if(depth < 2)
+	{
+		depth = 2;
+	}
+
+	if(depth > EVE_PIPE_DEPTH_MAX)
+	{
+		depth = EVE_PIPE_DEPTH_MAX;
+	}
+
+	for(index = 0; index < EVE_PIPE_DEPTH_MAX; index++)
+	{
+		pipe_stage[index].state = EVE_PIPE_FREE;
+	}
+
+	pipe_depth = depth;
+	pipe_head = 0;
+	pipe_tail = 0;
+	pipe_used = 0;
+	pipe_write = EVE_report_cmdoffset();
+	ticks_per_us = EVE_memRead32(REG_FREQUENCY) / 1000000UL;
+
+	if(ticks_per_us == 0)
+	{
+		ticks_per_us = 1;
+	}
+
+	EVE_pipe_stats_reset();
+}
+
+
+static void EVE_pipe_measure(uint32_t ticks, uint32_t *avg, uint32_t *max)
+{
+	uint32_t us = ticks / ticks_per_us;
+
+	if(us > *max)
+	{
+		*max = us;
+	}
+
+	if(pipe_stats.frames <= 1)
+	{
+		*avg = us;
+	}
+	else
+	{
+		*avg = *avg - (*avg / 16) + (us / 16);
+	}
+}
+
+
+/* start to encode the next frame, returns 0 if the pipeline is full */
+uint8_t EVE_pipe_begin(void)
+{
+	EVE_pipe_stage_t *stage;
+
+	if(pipe_used >= pipe_depth)
+	{
+		EVE_pipe_commit();
+
+		if(pipe_used >= pipe_depth)
+		{
+			return 0;
+		}
+	}
+
+	if(pipe_used == 0) /* something else might have used the command-fifo since the last frame */
+	{
+		pipe_write = EVE_report_cmdoffset();
+	}
+
+	stage = &pipe_stage[pipe_head];
+	stage->state = EVE_PIPE_ENCODING;
+	stage->offset = EVE_report_cmdoffset();
+	stage->clock = EVE_memRead32(REG_CLOCK);
+	pipe_used++;
+
+	EVE_start_cmd_stage(stage->buffer);
+	return 1;
+}
+
+
+/* finish the frame and try to write it to the command-fifo right away, returns 0 if the frame was too big for the buffer */
+uint8_t EVE_pipe_end(void)
+{
+	EVE_pipe_stage_t *stage;
+	uint32_t now;
+
+	stage = &pipe_stage[pipe_head];
+	stage->length = EVE_end_cmd_stage();
+
+	if(stage->length == 0)
+	{
+		stage->state = EVE_PIPE_FREE;
+		pipe_used--;
+		pipe_stats.dropped++;
+		return 0;
+	}
+
+	now = EVE_memRead32(REG_CLOCK);
+	EVE_pipe_measure(now - stage->clock, &pipe_stats.encode_avg, &pipe_stats.encode_max);
+	stage->clock = now;
+	stage->state = EVE_PIPE_STAGED;
+
+	pipe_head++;
+	if(pipe_head >= pipe_depth)
+	{
+		pipe_head = 0;
+	}
+
+	EVE_pipe_commit();
+	return 1;
+}
+
+
+/* retire the frames the co-processor is done with and write staged frames to the command-fifo as long as there is space */
+/* returns the number of frames in the pipeline, this is meant to be called outside display-list building */
+uint8_t EVE_pipe_commit(void)
+{
+	EVE_pipe_stage_t *stage;
+	uint32_t now;
+	uint16_t pending;
+	uint16_t after;
+	uint16_t first;
+	uint8_t index;
+	uint8_t count;
+
+	#if defined (EVE_DMA)
+	if(EVE_dma_busy)
+	{
+		return pipe_used;
+	}
+	#endif
+
+	if(pipe_used == 0)
+	{
+		return 0;
+	}
+
+	pending = (pipe_write - EVE_memRead16(REG_CMD_READ)) & 0x0fff; /* bytes the co-processor still has to work thru */
+	now = EVE_memRead32(REG_CLOCK);
+
+	/* a running frame is done when the bytes that were written after it are not less than the bytes that are pending */
+	while((pipe_used != 0) && (pipe_stage[pipe_tail].state == EVE_PIPE_RUNNING))
+	{
+		after = 0;
+		index = pipe_tail;
+
+		for(count = 1; count < pipe_used; count++)
+		{
+			index++;
+			if(index >= pipe_depth)
+			{
+				index = 0;
+			}
+
+			if(pipe_stage[index].state == EVE_PIPE_RUNNING)
+			{
+				after += pipe_stage[index].length;
+			}
+		}
+
+		if(after < pending)
+		{
+			break;
+		}
+
+		stage = &pipe_stage[pipe_tail];
+		EVE_pipe_measure(now - stage->clock, &pipe_stats.execute_avg, &pipe_stats.execute_max);
+		stage->state = EVE_PIPE_FREE;
+		pipe_used--;
+
+		pipe_tail++;
+		if(pipe_tail >= pipe_depth)
+		{
+			pipe_tail = 0;
+		}
+	}
+
+	/* write the staged frames in order */
+	index = pipe_tail;
+	for(count = 0; count < pipe_used; count++)
+	{
+		stage = &pipe_stage[index];
+
+		if(stage->state == EVE_PIPE_STAGED)
+		{
+			if(stage->length > (4092 - pending))
+			{
+				break;
+			}
+
+			first = 4096 - stage->offset;
+			if(first > stage->length)
+			{
+				first = stage->length;
+			}
+
+			EVE_memWrite_sram_buffer(EVE_RAM_CMD + stage->offset, stage->buffer, first);
+
+			if(first < stage->length) /* wrap-around */
+			{
+				EVE_memWrite_sram_buffer(EVE_RAM_CMD, &stage->buffer[first], stage->length - first);
+			}
+
+			pipe_write = (stage->offset + stage->length) & 0x0fff;
+			EVE_memWrite16(REG_CMD_WRITE, pipe_write);
+			pending += stage->length;
+
+			pipe_stats.frames++;
+			EVE_pipe_measure(now - stage->clock, &pipe_stats.queue_avg, &pipe_stats.queue_max);
+			stage->clock = now;
+			stage->state = EVE_PIPE_RUNNING;
+		}
+		else if(stage->state == EVE_PIPE_ENCODING)
+		{
+			break;
+		}
+
+		index++;
+		if(index >= pipe_depth)
+		{
+			index = 0;
+		}
+	}
+
+	return pipe_used;
+}
+
+
+/* write all frames to the command-fifo and wait for the co-processor to finish them */
+void EVE_pipe_flush(void)
+{
+	while(EVE_pipe_commit() != 0);
+}
+
+
+void EVE_pipe_report(EVE_pipe_stats_t *stats)
+{
+	*stats = pipe_stats;
+}
+
+#endif
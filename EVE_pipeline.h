@@ -0,0 +1,44 @@
+/*
+@file    EVE_pipeline.h
+@brief   prototypes for pipelined frame submission
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_PIPELINE_H_
+#define EVE_PIPELINE_H_
+
+#if defined (EVE_PIPELINE)
+
+#define EVE_PIPE_DEPTH_MAX 3
+
+typedef struct
+{
+	uint32_t frames;		/* frames that were written to the command-fifo */
+	uint32_t dropped;		/* frames that did not fit into a staging buffer */
+	uint32_t encode_avg;	/* us from EVE_pipe_begin() to EVE_pipe_end() */
+	uint32_t encode_max;
+	uint32_t queue_avg;		/* us from EVE_pipe_end() until the frame was written to the command-fifo */
+	uint32_t queue_max;
+	uint32_t execute_avg;	/* us from writing the frame to the command-fifo until the co-processor was done with it */
+	uint32_t execute_max;
+} EVE_pipe_stats_t;
+
+void EVE_pipe_init(uint8_t depth);
+uint8_t EVE_pipe_begin(void);
+uint8_t EVE_pipe_end(void);
+uint8_t EVE_pipe_commit(void);
+void EVE_pipe_flush(void);
+void EVE_pipe_report(EVE_pipe_stats_t *stats);
+void EVE_pipe_stats_reset(void);
+
+#endif
+
+#endif /* EVE_PIPELINE_H_ */
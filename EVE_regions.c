@@ -0,0 +1,146 @@
+/*
+@file    EVE_regions.c
+@brief   screen regions with dirty-tracking, unchanged regions are added from RAM_G, changed ones are drawn with a scissor
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+EVE has no frame-buffer, every frame is rendered from the display-list, so a display-list always needs to describe
+the whole screen. But most of it does not change from one frame to the next.
+The screen is divided into regions, the first one usually is the full-screen base with everything static.
+A region that did not change is added to the list from a copy in RAM_G with a single CMD_APPEND,
+a region that changed is drawn thru its draw() function, clipped with SCISSOR_XY / SCISSOR_SIZE to its area.
+Once a region did not change for a frame EVE_regions_update() copies it to RAM_G again.
+
+static void draw_base(void) { ... }
+static void draw_speed(void) { EVE_cmd_number(...); }
+
+EVE_region_t base = {0, 0, EVE_HSIZE, EVE_VSIZE, draw_base};
+EVE_region_t speed = {300, 200, 120, 40, draw_speed};
+
+EVE_segment_pool(MEM_SEGMENTS, 32768);
+EVE_regions_init();
+EVE_region_add(&base);
+EVE_region_add(&speed);
+
+EVE_start_cmd_burst();
+EVE_cmd_dl(CMD_DLSTART);
+EVE_cmd_dl(DL_CLEAR | CLR_COL | CLR_STN | CLR_TAG);
+EVE_regions_draw();
+EVE_cmd_dl(DL_DISPLAY);
+EVE_cmd_dl(CMD_SWAP);
+EVE_end_cmd_burst();
+EVE_cmd_execute();
+EVE_regions_update();
+
+and EVE_region_dirty(&speed) whenever the speed changed.
+EVE_regions_update() needs to be called outside display-list building.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+#include "EVE_regions.h"
+
+
+#define EVE_REGION_STALE	0	/* there is no valid copy in RAM_G */
+#define EVE_REGION_CACHED	1
+
+static EVE_region_t *regions[EVE_REGIONS_MAX];
+static uint8_t regions_count = 0;
+
+
+void EVE_regions_init(void)
+{
+	regions_count = 0;
+}
+
+
+/* regions are drawn in the order they were added, returns 0 if there is no space left */
+uint8_t EVE_region_add(EVE_region_t *region)
+{
+	if(regions_count >= EVE_REGIONS_MAX)
+	{
+		return 0;
+	}
+
+	region->segment.ptr = 0;
+	region->segment.size = 0;
+	region->segment.num = 0;
+	region->state = EVE_REGION_STALE;
+	region->changed = 1;
+	regions[regions_count++] = region;
+	return 1;
+}
+
+
+void EVE_region_dirty(EVE_region_t *region)
+{
+	region->state = EVE_REGION_STALE;
+	region->changed = 1;
+}
+
+
+static void EVE_region_draw(const EVE_region_t *region)
+{
+	EVE_cmd_dl(DL_SAVE_CONTEXT);
+	EVE_cmd_dl(SCISSOR_XY(region->x0, region->y0));
+	EVE_cmd_dl(SCISSOR_SIZE(region->w0, region->h0));
+	region->draw();
+	EVE_cmd_dl(DL_RESTORE_CONTEXT);
+}
+
+
+/* add all regions to the display-list that currently is build */
+void EVE_regions_draw(void)
+{
+	EVE_region_t *region;
+	uint8_t index;
+
+	for(index = 0; index < regions_count; index++)
+	{
+		region = regions[index];
+
+		if(region->state == EVE_REGION_CACHED)
+		{
+			EVE_segment_append(&region->segment);
+		}
+		else
+		{
+			EVE_region_draw(region);
+		}
+	}
+}
+
+
+/* copy the regions that did not change since the last call to RAM_G, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_regions_update(void)
+{
+	EVE_region_t *region;
+	uint8_t index;
+
+	for(index = 0; index < regions_count; index++)
+	{
+		region = regions[index];
+
+		if((region->state == EVE_REGION_STALE) && (region->changed == 0))
+		{
+			EVE_segment_start();
+			EVE_region_draw(region);
+
+			if(EVE_segment_end(&region->segment) != 0)
+			{
+				region->state = EVE_REGION_CACHED;
+			}
+		}
+
+		region->changed = 0;
+	}
+}
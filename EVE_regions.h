@@ -0,0 +1,38 @@
+/*
+@file    EVE_regions.h
+@brief   prototypes for the screen regions with dirty-tracking
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_REGIONS_H_
+#define EVE_REGIONS_H_
+
+#define EVE_REGIONS_MAX 16
+
+typedef struct
+{
+	int16_t x0;		/* area on the screen, drawing is clipped to it with SCISSOR_XY / SCISSOR_SIZE */
+	int16_t y0;
+	uint16_t w0;
+	uint16_t h0;
+	void (*draw)(void);	/* draws the content of the region with the usual EVE_cmd_xxx() functions */
+	EVE_segment_t segment;	/* managed by EVE_regions.c */
+	uint8_t state;
+	uint8_t changed;
+} EVE_region_t;
+
+void EVE_regions_init(void);
+uint8_t EVE_region_add(EVE_region_t *region);
+void EVE_region_dirty(EVE_region_t *region);
+void EVE_regions_draw(void);
+void EVE_regions_update(void);
+
+#endif /* EVE_REGIONS_H_ */
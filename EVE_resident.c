@@ -0,0 +1,475 @@
+/*
+@file    EVE_resident.c
+@brief   RAM_G residency cache, assets are loaded from the flash or the host when they are drawn and evicted when not used
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+A part of RAM_G is given to the cache, assets are identified by a 16 bit id.
+EVE_resident_draw() draws an asset that is resident and counts a hit, an asset that is not resident counts a miss,
+is not drawn in this frame and is loaded by EVE_resident_update() after the frame.
+EVE_resident_prefetch() requests an asset for the next screen, prefetched assets are loaded after the misses
+and only if there is free space for them.
+When there is no space left for a miss the assets that were not used for the longest time are evicted,
+assets that were drawn in the current frame are never evicted.
+
+With BT81X_ENABLE the assets are taken from the flash directory by their id, see EVE_flashfs.c.
+EVE_resident_source() sets functions that describe and load assets from somewhere else, from the host for example.
+
+EVE_segment_pool(MEM_SEGMENTS, 4096);
+EVE_bitmap_init(0x7fff);
+EVE_flashfs_mount(MEM_SCRATCH);
+EVE_resident_init(0x40000, 0xC0000);
+
+EVE_start_cmd_burst();
+EVE_cmd_dl(CMD_DLSTART);
+EVE_bitmap_prologue();
+...
+EVE_resident_draw(ICON_WIFI, 10, 10);
+...
+EVE_cmd_dl(CMD_SWAP);
+EVE_end_cmd_burst();
+EVE_cmd_execute();
+EVE_bitmap_update();
+EVE_resident_prefetch(PICTURE_SETTINGS);
+EVE_resident_update();
+
+The bitmaps are drawn with EVE_cmd_bitmap() so they share the handles managed by EVE_bitmaps.c.
+EVE_resident_update() and EVE_resident_load() are meant to be called outside display-list building, do not support cmd-burst.
+
+@section History
+
+4.1
+- first version
+- prefetching does not evict assets anymore
+- EVE_resident_source() ignores a missing function
+
+*/
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_bitmaps.h"
+#include "EVE_flashfs.h"
+#include "EVE_resident.h"
+
+
+#define EVE_RESIDENT_ALIGN 4UL
+
+typedef struct
+{
+	EVE_bitmap_t bitmap;	/* bitmap.addr is where the asset is in RAM_G */
+	uint32_t size;			/* 0 for an unused entry */
+	uint16_t id;
+	uint16_t used;			/* frame in which the asset was drawn last */
+} EVE_resident_entry_t;
+
+typedef struct
+{
+	uint16_t id;
+	uint8_t prefetch;
+} EVE_resident_request_t;
+
+static EVE_resident_entry_t resident[EVE_RESIDENT_ENTRIES];
+static EVE_resident_request_t resident_queue[EVE_RESIDENT_QUEUE];
+static uint8_t resident_queued = 0;
+static uint32_t resident_start = 0;
+static uint32_t resident_end = 0;
+static uint16_t resident_frame = 0;
+static uint32_t resident_hits = 0;
+static uint32_t resident_misses = 0;
+static uint32_t resident_loaded = 0;
+static uint32_t resident_evictions = 0;
+static EVE_resident_describe_t resident_describe = 0;
+static EVE_resident_load_t resident_load = 0;
+
+
+#if defined (BT81X_ENABLE)
+/* bytes a bitmap takes in RAM_G, 0 for formats that are not known here */
+static uint32_t EVE_resident_bitmap_size(const EVE_bitmap_t *bitmap)
+{
+	uint32_t stride;
+
+	switch(bitmap->format)
+	{
+		case EVE_L1:
+			stride = (bitmap->width + 7UL) / 8;
+			break;
+		case EVE_L2:
+			stride = (bitmap->width + 3UL) / 4;
+			break;
+		case EVE_L4:
+			stride = (bitmap->width + 1UL) / 2;
+			break;
+		case EVE_L8:
+		case EVE_RGB332:
+		case EVE_ARGB2:
+		case EVE_PALETTED8:
+			stride = bitmap->width;
+			break;
+		case EVE_ARGB1555:
+		case EVE_ARGB4:
+		case EVE_RGB565:
+			stride = bitmap->width * 2UL;
+			break;
+		default:
+			return 0;
+	}
+
+	return stride * bitmap->height;
+}
+
+
+static uint32_t EVE_resident_flash_describe(uint16_t id, EVE_bitmap_t *bitmap)
+{
+	const EVE_flashfs_entry_t *entry = EVE_flashfs_find_id(id);
+
+	if(entry == 0)
+	{
+		return 0;
+	}
+
+	bitmap->format = entry->format;
+	bitmap->width = entry->width;
+	bitmap->height = entry->height;
+
+	/* a deflated asset needs the space of the bitmap it inflates to */
+	return ((entry->flags & EVE_FLASHFS_DEFLATED) != 0) ? EVE_resident_bitmap_size(bitmap) : entry->size;
+}
+
+
+static uint8_t EVE_resident_flash_load(uint16_t id, uint32_t address)
+{
+	return EVE_flashfs_load(EVE_flashfs_find_id(id), address);
+}
+#endif
+
+
+/* the cache uses size bytes of RAM_G from start, everything that was resident is dropped */
+void EVE_resident_init(uint32_t start, uint32_t size)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_RESIDENT_ENTRIES; index++)
+	{
+		if(resident[index].size != 0)
+		{
+			EVE_bitmap_release(&resident[index].bitmap);
+		}
+
+		resident[index].size = 0;
+		resident[index].bitmap.handle = 0;
+	}
+
+	resident_start = (start + EVE_RESIDENT_ALIGN - 1) & ~(EVE_RESIDENT_ALIGN - 1);
+	resident_end = start + size;
+	resident_queued = 0;
+	resident_hits = 0;
+	resident_misses = 0;
+	resident_loaded = 0;
+	resident_evictions = 0;
+
+	#if defined (BT81X_ENABLE)
+	if(resident_describe == 0)
+	{
+		resident_describe = EVE_resident_flash_describe;
+		resident_load = EVE_resident_flash_load;
+	}
+	#endif
+}
+
+
+/* both functions are needed, the source is left as it is when one of them is 0 */
+void EVE_resident_source(EVE_resident_describe_t describe, EVE_resident_load_t load)
+{
+	if((describe == 0) || (load == 0))
+	{
+		return;
+	}
+
+	resident_describe = describe;
+	resident_load = load;
+}
+
+
+uint32_t EVE_resident_hits(void)
+{
+	return resident_hits;
+}
+
+
+uint32_t EVE_resident_misses(void)
+{
+	return resident_misses;
+}
+
+
+/* bytes that were loaded into RAM_G */
+uint32_t EVE_resident_loaded(void)
+{
+	return resident_loaded;
+}
+
+
+uint32_t EVE_resident_evictions(void)
+{
+	return resident_evictions;
+}
+
+
+static EVE_resident_entry_t *EVE_resident_find(uint16_t id)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_RESIDENT_ENTRIES; index++)
+	{
+		if((resident[index].size != 0) && (resident[index].id == id))
+		{
+			return &resident[index];
+		}
+	}
+
+	return 0;
+}
+
+
+static void EVE_resident_drop(EVE_resident_entry_t *entry)
+{
+	EVE_bitmap_release(&entry->bitmap);
+	entry->size = 0;
+	resident_evictions++;
+}
+
+
+/* the lowest address with size bytes free, 0xFFFFFFFF if there is no such gap */
+static uint32_t EVE_resident_gap(uint32_t size)
+{
+	uint32_t address = resident_start;
+	uint32_t end;
+	uint8_t index, moved;
+
+	do
+	{
+		moved = 0;
+
+		for(index = 0; index < EVE_RESIDENT_ENTRIES; index++)
+		{
+			if(resident[index].size == 0)
+			{
+				continue;
+			}
+
+			end = resident[index].bitmap.addr + resident[index].size;
+
+			if((resident[index].bitmap.addr < (address + size)) && (end > address))
+			{
+				address = (end + EVE_RESIDENT_ALIGN - 1) & ~(EVE_RESIDENT_ALIGN - 1); /* overlaps, try behind it */
+				moved = 1;
+			}
+		}
+	} while(moved && ((address + size) <= resident_end));
+
+	return ((address + size) <= resident_end) ? address : 0xFFFFFFFFUL;
+}
+
+
+/* makes an asset resident, with evict != 0 the least recently used assets that were not drawn in the current frame */
+/* are evicted to make space, with evict == 0 it is only loaded into space that is free */
+static EVE_resident_entry_t *EVE_resident_make(uint16_t id, uint8_t evict)
+{
+	EVE_resident_entry_t *entry = 0;
+	EVE_bitmap_t bitmap;
+	uint32_t size, address;
+	uint16_t age, oldest;
+	uint8_t index, victim;
+
+	if((resident_describe == 0) || (resident_load == 0)) /* nothing is evicted without a way to load the asset */
+	{
+		return 0;
+	}
+
+	size = resident_describe(id, &bitmap);
+	size = (size + 3UL) & ~3UL;
+
+	if((size == 0) || (size > (resident_end - resident_start)))
+	{
+		return 0;
+	}
+
+	for(;;)
+	{
+		address = EVE_resident_gap(size);
+
+		if(entry == 0)
+		{
+			for(index = 0; index < EVE_RESIDENT_ENTRIES; index++)
+			{
+				if(resident[index].size == 0)
+				{
+					entry = &resident[index];
+					break;
+				}
+			}
+		}
+
+		if((address != 0xFFFFFFFFUL) && (entry != 0))
+		{
+			break;
+		}
+
+		if(evict == 0)
+		{
+			return 0;
+		}
+
+		victim = EVE_RESIDENT_ENTRIES;
+		oldest = 0;
+
+		for(index = 0; index < EVE_RESIDENT_ENTRIES; index++)
+		{
+			age = resident_frame - resident[index].used;
+
+			if((resident[index].size != 0) && (age != 0) && (age >= oldest))
+			{
+				oldest = age;
+				victim = index;
+			}
+		}
+
+		if(victim == EVE_RESIDENT_ENTRIES) /* everything that is left is on the screen */
+		{
+			return 0;
+		}
+
+		EVE_resident_drop(&resident[victim]);
+	}
+
+	if(resident_load(id, address) == 0)
+	{
+		return 0;
+	}
+
+	entry->bitmap.addr = address;
+	entry->bitmap.format = bitmap.format;
+	entry->bitmap.width = bitmap.width;
+	entry->bitmap.height = bitmap.height;
+	entry->bitmap.handle = 0;
+	entry->size = size;
+	entry->id = id;
+	entry->used = resident_frame; /* not evicted again by the loads that follow in this update */
+	resident_loaded += size;
+	return entry;
+}
+
+
+static void EVE_resident_request(uint16_t id, uint8_t prefetch)
+{
+	uint8_t index;
+
+	for(index = 0; index < resident_queued; index++)
+	{
+		if(resident_queue[index].id == id)
+		{
+			resident_queue[index].prefetch &= prefetch;
+			return;
+		}
+	}
+
+	if(resident_queued < EVE_RESIDENT_QUEUE)
+	{
+		resident_queue[resident_queued].id = id;
+		resident_queue[resident_queued].prefetch = prefetch;
+		resident_queued++;
+	}
+}
+
+
+/* the bitmap of a resident asset, it is marked as used in the current frame, 0 if it is not resident and was requested */
+EVE_bitmap_t *EVE_resident_get(uint16_t id)
+{
+	EVE_resident_entry_t *entry = EVE_resident_find(id);
+
+	if(entry == 0)
+	{
+		resident_misses++;
+		EVE_resident_request(id, 0);
+		return 0;
+	}
+
+	resident_hits++;
+	entry->used = resident_frame;
+	return &entry->bitmap;
+}
+
+
+/* draws a resident asset at x0 / y0, returns 0 when it is not resident yet and will be loaded by EVE_resident_update() */
+uint8_t EVE_resident_draw(uint16_t id, int16_t x0, int16_t y0)
+{
+	EVE_bitmap_t *bitmap = EVE_resident_get(id);
+
+	if(bitmap == 0)
+	{
+		return 0;
+	}
+
+	EVE_cmd_bitmap(bitmap, x0, y0);
+	return 1;
+}
+
+
+/* asks for an asset to be loaded by EVE_resident_update() if there is space, without counting a miss */
+void EVE_resident_prefetch(uint16_t id)
+{
+	if(EVE_resident_find(id) == 0)
+	{
+		EVE_resident_request(id, 1);
+	}
+}
+
+
+/* makes an asset resident right away, this is meant to be called outside display-list building, does not support cmd-burst */
+EVE_bitmap_t *EVE_resident_load(uint16_t id)
+{
+	EVE_resident_entry_t *entry = EVE_resident_find(id);
+
+	if(entry == 0)
+	{
+		entry = EVE_resident_make(id, 1);
+	}
+
+	return (entry != 0) ? &entry->bitmap : 0;
+}
+
+
+void EVE_resident_evict(uint16_t id)
+{
+	EVE_resident_entry_t *entry = EVE_resident_find(id);
+
+	if(entry != 0)
+	{
+		EVE_resident_drop(entry);
+	}
+}
+
+
+/* loads the assets that were missed and then the ones that were prefetched, meant to be called after each frame */
+/* prefetched assets only use free space, they never evict anything */
+/* this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_resident_update(void)
+{
+	uint8_t index, pass;
+
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(index = 0; index < resident_queued; index++)
+		{
+			if((resident_queue[index].prefetch == pass) && (EVE_resident_find(resident_queue[index].id) == 0))
+			{
+				EVE_resident_make(resident_queue[index].id, (uint8_t) (pass == 0));
+			}
+		}
+	}
+
+	resident_queued = 0;
+	resident_frame++;
+}
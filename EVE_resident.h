@@ -0,0 +1,44 @@
+/*
+@file    EVE_resident.h
+@brief   prototypes for the RAM_G residency cache for assets that are loaded from the flash or the host
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_RESIDENT_H_
+#define EVE_RESIDENT_H_
+
+#if !defined (EVE_RESIDENT_ENTRIES)
+#define EVE_RESIDENT_ENTRIES 32	/* assets that can be resident at the same time */
+#endif
+
+#if !defined (EVE_RESIDENT_QUEUE)
+#define EVE_RESIDENT_QUEUE 16	/* requests that are loaded by the next EVE_resident_update() */
+#endif
+
+typedef uint32_t (*EVE_resident_describe_t)(uint16_t id, EVE_bitmap_t *bitmap);	/* returns the bytes needed in RAM_G, 0 if there is no such asset */
+typedef uint8_t (*EVE_resident_load_t)(uint16_t id, uint32_t address);	/* copies the asset to address, returns 0 on failure */
+
+void EVE_resident_init(uint32_t start, uint32_t size);
+void EVE_resident_source(EVE_resident_describe_t describe, EVE_resident_load_t load);
+
+uint8_t EVE_resident_draw(uint16_t id, int16_t x0, int16_t y0);
+EVE_bitmap_t *EVE_resident_get(uint16_t id);
+void EVE_resident_prefetch(uint16_t id);
+EVE_bitmap_t *EVE_resident_load(uint16_t id);
+void EVE_resident_evict(uint16_t id);
+void EVE_resident_update(void);
+
+uint32_t EVE_resident_hits(void);
+uint32_t EVE_resident_misses(void);
+uint32_t EVE_resident_loaded(void);
+uint32_t EVE_resident_evictions(void);
+
+#endif /* EVE_RESIDENT_H_ */
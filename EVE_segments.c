@@ -0,0 +1,254 @@
+/*
+@file    EVE_segments.c
+@brief   pre-expanded display-list segments in RAM_G
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+RAM_DL only has 8k and the co-processor widgets need a lot of it, a dense screen can easily run out of space
+and whatever does not fit anymore is silently lost.
+Parts of a screen that rarely change can be build once, copied from RAM_DL to RAM_G and from then on added
+to every display-list with CMD_APPEND, this costs only the bytes the segment really has and saves
+the co-processor from expanding the widgets over and over again.
+
+Segments can not be captured while a display-list is build as capturing uses RAM_DL, so capture them before CMD_DLSTART:
+
+EVE_segment_pool(MEM_SEGMENTS, 16384);
+
+EVE_segment_start();
+EVE_cmd_dl(DL_COLOR_RGB | BLACK);
+EVE_cmd_gauge(...);
+EVE_cmd_text(...);
+EVE_segment_end(&background);
+
+EVE_start_cmd_burst();
+EVE_cmd_dl(CMD_DLSTART);
+EVE_cmd_dl(DL_CLEAR_RGB | WHITE);
+EVE_cmd_dl(DL_CLEAR | CLR_COL | CLR_STN | CLR_TAG);
+EVE_segment_append(&background);
+...
+
+A segment that is captured again re-uses its space in RAM_G as long as the new list fits into it.
+When it does not fit, a segment that is the last one in the pool grows in place, any other segment gets new space
+with a quarter more than it needs now, so a segment that keeps growing only moves a few times.
+The pool is a simple linear allocator, the space a segment moved away from is not used again until
+EVE_segment_pool_reset() releases all segments at once. A segment that does not fit anymore has num set to 0
+and needs to be drawn directly, so the pool should have room for the largest size of the segments that grow.
+
+@section History
+
+4.1
+- first version
+- added EVE_segment_length() for captures into memory that is not managed by the pool
+- a segment that grows is extended in place when it is the last in the pool and moved with headroom otherwise
+- added EVE_segment_lookup(), the hash and the replacement the label and the widget cache had each
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+
+
+static uint32_t pool_next = 0;
+static uint32_t pool_end = 0;
+static uint32_t pool_start = 0;
+
+
+/* set the area in RAM_G that is used for segments */
+void EVE_segment_pool(uint32_t start, uint32_t size)
+{
+	start = (start + 3) & ~3UL; /* display-lists need to be 4-byte aligned */
+	pool_start = start;
+	pool_next = start;
+	pool_end = start + size;
+}
+
+
+/* release all segments, every EVE_segment_t needs to be set to zero again before it is used after this */
+void EVE_segment_pool_reset(void)
+{
+	pool_next = pool_start;
+}
+
+
+/* reserve space in the pool, returns EVE_SEGMENT_NONE if there is not enough left */
+uint32_t EVE_segment_alloc(uint32_t size)
+{
+	uint32_t ptr;
+
+	size = (size + 3) & ~3UL;
+
+	if((pool_next + size) > pool_end)
+	{
+		return EVE_SEGMENT_NONE;
+	}
+
+	ptr = pool_next;
+	pool_next += size;
+	return ptr;
+}
+
+
+uint32_t EVE_segment_pool_left(void)
+{
+	return pool_end - pool_next;
+}
+
+
+/* start to capture a new segment, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_segment_start(void)
+{
+	EVE_cmd_dl(CMD_DLSTART);
+}
+
+
+/* execute what was build since EVE_segment_start() and copy the result from RAM_DL to RAM_G */
+/* returns 1 on success and 0 if there is not enough space left in the pool */
+uint8_t EVE_segment_end(EVE_segment_t *segment)
+{
+	uint16_t num;
+	uint32_t ptr;
+
+	num = EVE_segment_length();
+
+	if(num > segment->size)
+	{
+		/* the last segment in the pool can simply grow */
+		if((segment->size != 0) && ((segment->ptr + segment->size) == pool_next) && ((segment->ptr + num) <= pool_end))
+		{
+			pool_next = (segment->ptr + num + 3) & ~3UL;
+			segment->size = (uint16_t) (pool_next - segment->ptr);
+		}
+		else
+		{
+			/* a quarter more for a segment that already had to move so it does not need to again for every few bytes */
+			ptr = EVE_segment_alloc((segment->size != 0) ? (num + (num / 4)) : num);
+
+			if((ptr == EVE_SEGMENT_NONE) && (segment->size != 0))
+			{
+				ptr = EVE_segment_alloc(num);
+			}
+
+			if(ptr == EVE_SEGMENT_NONE)
+			{
+				segment->num = 0;
+				return 0;
+			}
+
+			segment->ptr = ptr;
+			segment->size = (uint16_t) (pool_next - ptr);
+		}
+	}
+
+	EVE_cmd_memcpy(segment->ptr, EVE_RAM_DL, num);
+	EVE_cmd_execute();
+
+	segment->num = num;
+	return 1;
+}
+
+
+/* execute what was build since EVE_segment_start() and return the length of the display-list, it is still in RAM_DL */
+uint16_t EVE_segment_length(void)
+{
+	EVE_cmd_execute();
+	return EVE_memRead16(REG_CMD_DL);
+}
+
+
+/* add the segment to the display-list that currently is build */
+void EVE_segment_append(const EVE_segment_t *segment)
+{
+	if(segment->num != 0)
+	{
+		EVE_cmd_append(segment->ptr, segment->num);
+	}
+}
+
+
+/* FNV-1a */
+static uint32_t EVE_segment_hash(const uint8_t *data, uint16_t size)
+{
+	uint32_t hash = 2166136261UL;
+	uint16_t index;
+
+	for(index = 0; index < size; index++)
+	{
+		hash ^= data[index];
+		hash *= 16777619UL;
+	}
+
+	return hash;
+}
+
+
+/*
+finds key in a table of count entries that are stride bytes apart, tags and keys point to the tag and the key of the first entry,
+the keys are compared with all their bytes so the padding of the keys needs to be cleared
+returns the index of the entry with the key and sets hit to 1, marking it as used in frame
+or returns the index of the entry to replace and sets hit to 0, that is an empty entry or the one that was not used for the longest time,
+the tag of that entry gets the hash and frame, the caller copies the key and sets the state
+count is returned when all entries were used in frame already
+*/
+uint8_t EVE_segment_lookup(EVE_segment_tag_t *tags, const void *keys, uint16_t stride, uint8_t count,
+	const void *key, uint16_t size, uint16_t frame, uint8_t *hit)
+{
+	EVE_segment_tag_t *tag;
+	uint32_t hash;
+	uint16_t age;
+	uint16_t oldest = 0;
+	uint8_t victim = count;
+	uint8_t empty = count;
+	uint8_t index;
+
+	hash = EVE_segment_hash((const uint8_t *) key, size);
+
+	for(index = 0; index < count; index++)
+	{
+		tag = (EVE_segment_tag_t *) ((uint8_t *) tags + ((uint32_t) index * stride));
+
+		if(tag->state == 0)
+		{
+			if(empty == count)
+			{
+				empty = index;
+			}
+			continue;
+		}
+
+		if((tag->hash == hash) && (memcmp((const uint8_t *) keys + ((uint32_t) index * stride), key, size) == 0))
+		{
+			tag->used = frame;
+			*hit = 1;
+			return index;
+		}
+
+		age = frame - tag->used; /* entries that were used in this frame already have an age of 0 and are not replaced */
+
+		if(age > oldest)
+		{
+			oldest = age;
+			victim = index;
+		}
+	}
+
+	*hit = 0;
+
+	if(empty != count)
+	{
+		victim = empty;
+	}
+
+	if(victim != count)
+	{
+		tag = (EVE_segment_tag_t *) ((uint8_t *) tags + ((uint32_t) victim * stride));
+		tag->hash = hash;
+		tag->used = frame;
+	}
+
+	return victim;
+}
@@ -0,0 +1,52 @@
+/*
+@file    EVE_segments.h
+@brief   prototypes for pre-expanded display-list segments in RAM_G
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+- added EVE_segment_length()
+- added EVE_segment_lookup() for the caches of segments
+
+*/
+
+#ifndef EVE_SEGMENTS_H_
+#define EVE_SEGMENTS_H_
+
+#define EVE_SEGMENT_NONE 0xFFFFFFFFUL
+
+typedef struct
+{
+	uint32_t ptr;	/* address in RAM_G */
+	uint16_t size;	/* space that is reserved at ptr */
+	uint16_t num;	/* length of the captured display-list, 0 if there is nothing to append */
+} EVE_segment_t;
+
+/* memory management */
+void EVE_segment_pool(uint32_t start, uint32_t size);
+void EVE_segment_pool_reset(void);
+uint32_t EVE_segment_alloc(uint32_t size);
+uint32_t EVE_segment_pool_left(void);
+
+/* capture and use */
+void EVE_segment_start(void);
+uint8_t EVE_segment_end(EVE_segment_t *segment);
+uint16_t EVE_segment_length(void);
+void EVE_segment_append(const EVE_segment_t *segment);
+
+/* caches of segments, like EVE_strings.c and EVE_widget_cache.c */
+typedef struct
+{
+	uint32_t hash;
+	uint16_t used;	/* frame in which the entry was used last */
+	uint8_t state;	/* 0 for an empty entry, the other values are up to the cache */
+} EVE_segment_tag_t;
+
+uint8_t EVE_segment_lookup(EVE_segment_tag_t *tags, const void *keys, uint16_t stride, uint8_t count,
+	const void *key, uint16_t size, uint16_t frame, uint8_t *hit);
+
+#endif /* EVE_SEGMENTS_H_ */
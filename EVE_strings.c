@@ -0,0 +1,272 @@
+/*
+@file    EVE_strings.c
+@brief   interned text labels, the display-list a label expands to is kept in RAM_G and added with CMD_APPEND
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+Static labels like "DL-size:" or "Bytes:" are sent thru the FIFO every frame and the co-processor expands
+them every frame to the same display-list commands.
+EVE_interned_text() and EVE_interned_button() take the same arguments as EVE_cmd_text() and EVE_cmd_button().
+The first time a label is used it is drawn as usual and put on the list to be captured by EVE_strings_update(),
+from then on it is added to the list with a single CMD_APPEND of 12 bytes.
+A label is identified by its string, font, options and position, a label that changes any of these
+is a new label and is expanded again, labels that are not used anymore are replaced when the table is full.
+Buttons also depend on the co-processor colors, text is drawn with the COLOR_RGB that is active where
+the segment is appended, so the same entry serves a label in any color.
+
+EVE_segment_pool(MEM_SEGMENTS, 16384);
+EVE_strings_init();
+
+EVE_start_cmd_burst();
+EVE_cmd_dl(CMD_DLSTART);
+...
+EVE_interned_text(10, EVE_VSIZE - 65, 26, 0, "Bytes: ");
+EVE_cmd_number(100, EVE_VSIZE - 65, 26, EVE_OPT_RIGHTX, num_dl_static);
+...
+EVE_cmd_dl(DL_DISPLAY);
+EVE_cmd_dl(CMD_SWAP);
+EVE_end_cmd_burst();
+EVE_cmd_execute();
+EVE_strings_update();
+
+EVE_strings_update() needs to be called outside display-list building as capturing the labels uses RAM_DL.
+The space in RAM_G is taken from the segment pool, a table entry that is replaced keeps its segment
+and re-uses it for the next label as long as that fits.
+Strings with EVE_OPT_FORMAT and strings longer than EVE_STRINGS_LENGTH are always sent directly.
+
+@section History
+
+4.1
+- first version
+- the lookup and the replacement of entries are done by EVE_segment_lookup()
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+#include "EVE_strings.h"
+
+
+#define EVE_STRING_EMPTY	0	/* the state of an empty EVE_segment_tag_t */
+#define EVE_STRING_PENDING	1	/* waiting to be captured by EVE_strings_update() */
+#define EVE_STRING_VALID	2
+#define EVE_STRING_NO_SPACE	3	/* there was no space left in the pool, always drawn directly */
+
+typedef struct
+{
+	uint32_t fgcolor;	/* co-processor colors, only used for buttons */
+	uint32_t gradcolor;
+	int16_t x0;
+	int16_t y0;
+	int16_t w0;
+	int16_t h0;
+	int16_t font;
+	uint16_t options;
+	uint8_t button;
+	char text[EVE_STRINGS_LENGTH + 1];
+} EVE_string_key_t;
+
+typedef struct
+{
+	EVE_segment_tag_t tag;
+	EVE_string_key_t key;
+	EVE_segment_t segment;
+} EVE_string_entry_t;
+
+static EVE_string_entry_t strings[EVE_STRINGS_ENTRIES];
+static uint16_t strings_frame = 0;
+static uint32_t strings_hits = 0;
+static uint32_t strings_misses = 0;
+static uint32_t strings_saved = 0;
+
+
+/* forget all labels, needs to be called again after EVE_segment_pool_reset() */
+void EVE_strings_init(void)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_STRINGS_ENTRIES; index++)
+	{
+		strings[index].tag.state = EVE_STRING_EMPTY;
+		strings[index].segment.ptr = 0;
+		strings[index].segment.size = 0;
+		strings[index].segment.num = 0;
+	}
+
+	strings_hits = 0;
+	strings_misses = 0;
+	strings_saved = 0;
+}
+
+
+uint32_t EVE_strings_hits(void)
+{
+	return strings_hits;
+}
+
+
+uint32_t EVE_strings_misses(void)
+{
+	return strings_misses;
+}
+
+
+/* the number of bytes that did not have to be sent thru the command FIFO */
+uint32_t EVE_strings_saved(void)
+{
+	return strings_saved;
+}
+
+
+static void EVE_string_draw(const EVE_string_key_t *key)
+{
+	if(key->button)
+	{
+		EVE_cmd_button(key->x0, key->y0, key->w0, key->h0, key->font, key->options, key->text);
+	}
+	else
+	{
+		EVE_cmd_text(key->x0, key->y0, key->font, key->options, key->text);
+	}
+}
+
+
+static void EVE_string_interned(const EVE_string_key_t *key)
+{
+	EVE_string_entry_t *entry;
+	uint8_t index, hit;
+
+	index = EVE_segment_lookup(&strings[0].tag, &strings[0].key, sizeof(EVE_string_entry_t), EVE_STRINGS_ENTRIES,
+		key, sizeof(EVE_string_key_t), strings_frame, &hit);
+
+	if(hit && (strings[index].tag.state == EVE_STRING_VALID))
+	{
+		strings_hits++;
+		/* the command with the string padded to 4 bytes against the 12 bytes of CMD_APPEND */
+		strings_saved += ((key->button ? 16U : 12U) + ((strlen(key->text) + 4U) & ~3U)) - 12U;
+		EVE_segment_append(&strings[index].segment);
+		return;
+	}
+
+	strings_misses++;
+
+	if((hit == 0) && (index != EVE_STRINGS_ENTRIES))
+	{
+		entry = &strings[index];
+		entry->key = *key;
+		entry->tag.state = EVE_STRING_PENDING;
+	}
+
+	EVE_string_draw(key);
+}
+
+
+/* expand the labels that were new in the last frame, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_strings_update(void)
+{
+	EVE_string_entry_t *entry;
+	uint32_t fgcolor, bgcolor, gradcolor;
+	uint8_t index;
+	uint8_t colors = 0;
+
+	EVE_report_copro_colors(&fgcolor, &bgcolor, &gradcolor);
+
+	for(index = 0; index < EVE_STRINGS_ENTRIES; index++)
+	{
+		entry = &strings[index];
+
+		if(entry->tag.state == EVE_STRING_PENDING)
+		{
+			EVE_segment_start();
+
+			if(entry->key.button)
+			{
+				EVE_cmd_fgcolor(entry->key.fgcolor);
+				EVE_cmd_gradcolor(entry->key.gradcolor);
+				colors = 1;
+			}
+
+			EVE_string_draw(&entry->key);
+
+			if(EVE_segment_end(&entry->segment) != 0)
+			{
+				entry->tag.state = EVE_STRING_VALID;
+			}
+			else
+			{
+				entry->tag.state = EVE_STRING_NO_SPACE;
+			}
+		}
+	}
+
+	if(colors)
+	{
+		EVE_cmd_fgcolor(fgcolor);
+		EVE_cmd_gradcolor(gradcolor);
+		EVE_cmd_execute();
+	}
+
+	strings_frame++;
+}
+
+
+static uint8_t EVE_string_key(EVE_string_key_t *key, int16_t x0, int16_t y0, int16_t font, uint16_t options, const char* text)
+{
+	if(strlen(text) > EVE_STRINGS_LENGTH)
+	{
+		return 0;
+	}
+
+	#if defined (BT81X_ENABLE)
+	if((options & EVE_OPT_FORMAT) != 0)
+	{
+		return 0;
+	}
+	#endif
+
+	memset(key, 0, sizeof(EVE_string_key_t)); /* the padding is part of the hash */
+	key->x0 = x0;
+	key->y0 = y0;
+	key->font = font;
+	key->options = options;
+	strcpy(key->text, text);
+	return 1;
+}
+
+
+void EVE_interned_text(int16_t x0, int16_t y0, int16_t font, uint16_t options, const char* text)
+{
+	EVE_string_key_t key;
+
+	if(EVE_string_key(&key, x0, y0, font, options, text) == 0)
+	{
+		EVE_cmd_text(x0, y0, font, options, text);
+		return;
+	}
+
+	EVE_string_interned(&key);
+}
+
+
+void EVE_interned_button(int16_t x0, int16_t y0, int16_t w0, int16_t h0, int16_t font, uint16_t options, const char* text)
+{
+	EVE_string_key_t key;
+	uint32_t bgcolor;
+
+	if(EVE_string_key(&key, x0, y0, font, options, text) == 0)
+	{
+		EVE_cmd_button(x0, y0, w0, h0, font, options, text);
+		return;
+	}
+
+	EVE_report_copro_colors(&key.fgcolor, &bgcolor, &key.gradcolor);
+	key.w0 = w0;
+	key.h0 = h0;
+	key.button = 1;
+	EVE_string_interned(&key);
+}
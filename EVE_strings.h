@@ -0,0 +1,30 @@
+/*
+@file    EVE_strings.h
+@brief   prototypes for interned text labels that are added from RAM_G
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_STRINGS_H_
+#define EVE_STRINGS_H_
+
+#define EVE_STRINGS_ENTRIES 32	/* maximum number of labels that are interned */
+#define EVE_STRINGS_LENGTH 32	/* longest label that still is interned */
+
+void EVE_strings_init(void);
+void EVE_strings_update(void);
+uint32_t EVE_strings_hits(void);
+uint32_t EVE_strings_misses(void);
+uint32_t EVE_strings_saved(void);
+
+void EVE_interned_text(int16_t x0, int16_t y0, int16_t font, uint16_t options, const char* text);
+void EVE_interned_button(int16_t x0, int16_t y0, int16_t w0, int16_t h0, int16_t font, uint16_t options, const char* text);
+
+#endif /* EVE_STRINGS_H_ */
@@ -0,0 +1,306 @@
+/*
+@file    EVE_widget_cache.c
+@brief   cache for the display-lists the co-processor expands gauges, clocks, dials and keys to
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+The co-processor expands CMD_GAUGE, CMD_CLOCK, CMD_DIAL and CMD_KEYS to a lot of display-list commands,
+it does so for every frame, even when nothing changed.
+The EVE_cached_xxx() functions hash their arguments together with the co-processor colors and look for a copy
+of the expanded display-list in RAM_G, if there is one it is added to the list with CMD_APPEND.
+If there is none the widget is drawn as usual and put on the list to be captured by EVE_widget_cache_update().
+
+The area in RAM_G is divided into slots of a fixed size, one for each widget, a widget that expands to more than
+a slot can hold is always drawn directly.
+When all slots are in use the one that was not used for the longest time is replaced.
+
+EVE_widget_cache_init(MEM_WIDGETS, 16384, 1024);
+
+EVE_start_cmd_burst();
+EVE_cmd_dl(CMD_DLSTART);
+...
+EVE_cached_gauge(...);
+...
+EVE_cmd_dl(DL_DISPLAY);
+EVE_cmd_dl(CMD_SWAP);
+EVE_end_cmd_burst();
+EVE_cmd_execute();
+EVE_widget_cache_update();
+
+EVE_widget_cache_update() needs to be called outside display-list building as capturing the widgets uses RAM_DL.
+Widgets with values that change every frame gain nothing from this.
+
+@section History
+
+4.1
+- first version
+- the lookup and the replacement of entries are done by EVE_segment_lookup()
+
+*/
+
+#include <string.h>
+
+#include "EVE.h"
+#include "EVE_config.h"
+#include "EVE_commands.h"
+#include "EVE_segments.h"
+#include "EVE_widget_cache.h"
+
+
+#define EVE_WIDGET_GAUGE	1
+#define EVE_WIDGET_CLOCK	2
+#define EVE_WIDGET_DIAL		3
+#define EVE_WIDGET_KEYS		4
+
+#define EVE_ENTRY_EMPTY		0	/* the state of an empty EVE_segment_tag_t */
+#define EVE_ENTRY_PENDING	1	/* waiting to be captured by EVE_widget_cache_update() */
+#define EVE_ENTRY_VALID		2
+#define EVE_ENTRY_TOO_BIG	3	/* does not fit into a slot, always drawn directly */
+
+typedef struct
+{
+	uint32_t fgcolor;
+	uint32_t bgcolor;
+	uint32_t gradcolor;
+	int16_t x0;
+	int16_t y0;
+	int16_t w0;		/* r0 for gauge, clock and dial */
+	int16_t h0;
+	uint16_t options;
+	uint16_t arg[4];
+	uint8_t widget;
+	char text[EVE_WIDGET_CACHE_TEXT + 1];
+} EVE_widget_key_t;
+
+typedef struct
+{
+	EVE_segment_tag_t tag;
+	EVE_widget_key_t key;
+	uint16_t num;	/* length of the captured display-list */
+} EVE_widget_entry_t;
+
+static EVE_widget_entry_t cache[EVE_WIDGET_CACHE_ENTRIES];
+static uint8_t cache_entries = 0;
+static uint32_t cache_start = 0;
+static uint16_t cache_slot = 0;
+static uint16_t cache_frame = 0;
+static uint32_t cache_hits = 0;
+static uint32_t cache_misses = 0;
+
+
+/* start is the address of the area in RAM_G that is used for the cache, size its length and slot the space for a single widget */
+void EVE_widget_cache_init(uint32_t start, uint32_t size, uint16_t slot)
+{
+	uint32_t entries;
+
+	slot = (slot + 3) & ~3U;
+	entries = (slot != 0) ? (size / slot) : 0;
+
+	if(entries > EVE_WIDGET_CACHE_ENTRIES)
+	{
+		entries = EVE_WIDGET_CACHE_ENTRIES;
+	}
+
+	cache_start = (start + 3) & ~3UL;
+	cache_slot = slot;
+	cache_entries = (uint8_t) entries;
+	EVE_widget_cache_clear();
+}
+
+
+void EVE_widget_cache_clear(void)
+{
+	uint8_t index;
+
+	for(index = 0; index < EVE_WIDGET_CACHE_ENTRIES; index++)
+	{
+		cache[index].tag.state = EVE_ENTRY_EMPTY;
+	}
+
+	cache_hits = 0;
+	cache_misses = 0;
+}
+
+
+uint32_t EVE_widget_cache_hits(void)
+{
+	return cache_hits;
+}
+
+
+uint32_t EVE_widget_cache_misses(void)
+{
+	return cache_misses;
+}
+
+
+static void EVE_widget_draw(const EVE_widget_key_t *key)
+{
+	switch(key->widget)
+	{
+		case EVE_WIDGET_GAUGE:
+			EVE_cmd_gauge(key->x0, key->y0, key->w0, key->options, key->arg[0], key->arg[1], key->arg[2], key->arg[3]);
+			break;
+
+		case EVE_WIDGET_CLOCK:
+			EVE_cmd_clock(key->x0, key->y0, key->w0, key->options, key->arg[0], key->arg[1], key->arg[2], key->arg[3]);
+			break;
+
+		case EVE_WIDGET_DIAL:
+			EVE_cmd_dial(key->x0, key->y0, key->w0, key->options, key->arg[0]);
+			break;
+
+		case EVE_WIDGET_KEYS:
+			EVE_cmd_keys(key->x0, key->y0, key->w0, key->h0, (int16_t) key->arg[0], key->options, key->text);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+static void EVE_widget_cached(const EVE_widget_key_t *key)
+{
+	EVE_widget_entry_t *entry;
+	uint8_t index, hit;
+
+	index = EVE_segment_lookup(&cache[0].tag, &cache[0].key, sizeof(EVE_widget_entry_t), cache_entries,
+		key, sizeof(EVE_widget_key_t), cache_frame, &hit);
+
+	if(hit && (cache[index].tag.state == EVE_ENTRY_VALID))
+	{
+		cache_hits++;
+		EVE_cmd_append(cache_start + ((uint32_t) index * cache_slot), cache[index].num);
+		return;
+	}
+
+	cache_misses++;
+
+	if((hit == 0) && (index != cache_entries))
+	{
+		entry = &cache[index];
+		entry->key = *key;
+		entry->tag.state = EVE_ENTRY_PENDING;
+	}
+
+	EVE_widget_draw(key);
+}
+
+
+/* capture the widgets that were missing in the last frame, this is meant to be called outside display-list building, does not support cmd-burst */
+void EVE_widget_cache_update(void)
+{
+	EVE_widget_entry_t *entry;
+	uint32_t fgcolor, bgcolor, gradcolor;
+	uint16_t num;
+	uint8_t index;
+	uint8_t captured = 0;
+
+	EVE_report_copro_colors(&fgcolor, &bgcolor, &gradcolor);
+
+	for(index = 0; index < cache_entries; index++)
+	{
+		entry = &cache[index];
+
+		if(entry->tag.state == EVE_ENTRY_PENDING)
+		{
+			EVE_segment_start();
+			EVE_cmd_fgcolor(entry->key.fgcolor);
+			EVE_cmd_bgcolor(entry->key.bgcolor);
+			EVE_cmd_gradcolor(entry->key.gradcolor);
+			EVE_widget_draw(&entry->key);
+			num = EVE_segment_length();
+
+			if(num <= cache_slot)
+			{
+				EVE_cmd_memcpy(cache_start + ((uint32_t) index * cache_slot), EVE_RAM_DL, num);
+				entry->num = num;
+				entry->tag.state = EVE_ENTRY_VALID;
+			}
+			else
+			{
+				entry->tag.state = EVE_ENTRY_TOO_BIG;
+			}
+
+			captured = 1;
+		}
+	}
+
+	if(captured)
+	{
+		EVE_cmd_fgcolor(fgcolor);
+		EVE_cmd_bgcolor(bgcolor);
+		EVE_cmd_gradcolor(gradcolor);
+		EVE_cmd_execute();
+	}
+
+	cache_frame++;
+}
+
+
+static void EVE_widget_key(EVE_widget_key_t *key, uint8_t widget, int16_t x0, int16_t y0, int16_t w0, int16_t h0, uint16_t options)
+{
+	memset(key, 0, sizeof(EVE_widget_key_t)); /* the padding is part of the hash */
+	EVE_report_copro_colors(&key->fgcolor, &key->bgcolor, &key->gradcolor);
+	key->widget = widget;
+	key->x0 = x0;
+	key->y0 = y0;
+	key->w0 = w0;
+	key->h0 = h0;
+	key->options = options;
+}
+
+
+void EVE_cached_gauge(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t major, uint16_t minor, uint16_t val, uint16_t range)
+{
+	EVE_widget_key_t key;
+
+	EVE_widget_key(&key, EVE_WIDGET_GAUGE, x0, y0, r0, 0, options);
+	key.arg[0] = major;
+	key.arg[1] = minor;
+	key.arg[2] = val;
+	key.arg[3] = range;
+	EVE_widget_cached(&key);
+}
+
+
+void EVE_cached_clock(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t hours, uint16_t minutes, uint16_t seconds, uint16_t millisecs)
+{
+	EVE_widget_key_t key;
+
+	EVE_widget_key(&key, EVE_WIDGET_CLOCK, x0, y0, r0, 0, options);
+	key.arg[0] = hours;
+	key.arg[1] = minutes;
+	key.arg[2] = seconds;
+	key.arg[3] = millisecs;
+	EVE_widget_cached(&key);
+}
+
+
+void EVE_cached_dial(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t val)
+{
+	EVE_widget_key_t key;
+
+	EVE_widget_key(&key, EVE_WIDGET_DIAL, x0, y0, r0, 0, options);
+	key.arg[0] = val;
+	EVE_widget_cached(&key);
+}
+
+
+void EVE_cached_keys(int16_t x0, int16_t y0, int16_t w0, int16_t h0, int16_t font, uint16_t options, const char* text)
+{
+	EVE_widget_key_t key;
+
+	if(strlen(text) > EVE_WIDGET_CACHE_TEXT)
+	{
+		EVE_cmd_keys(x0, y0, w0, h0, font, options, text);
+		return;
+	}
+
+	EVE_widget_key(&key, EVE_WIDGET_KEYS, x0, y0, w0, h0, options);
+	key.arg[0] = (uint16_t) font;
+	strcpy(key.text, text);
+	EVE_widget_cached(&key);
+}
@@ -0,0 +1,32 @@
+/*
+@file    EVE_widget_cache.h
+@brief   prototypes for the widget expansion cache
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_WIDGET_CACHE_H_
+#define EVE_WIDGET_CACHE_H_
+
+#define EVE_WIDGET_CACHE_ENTRIES 16	/* maximum number of widgets in the cache */
+#define EVE_WIDGET_CACHE_TEXT 24	/* longest string for EVE_cached_keys() that still is cached */
+
+void EVE_widget_cache_init(uint32_t start, uint32_t size, uint16_t slot);
+void EVE_widget_cache_clear(void);
+void EVE_widget_cache_update(void);
+uint32_t EVE_widget_cache_hits(void);
+uint32_t EVE_widget_cache_misses(void);
+
+void EVE_cached_gauge(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t major, uint16_t minor, uint16_t val, uint16_t range);
+void EVE_cached_clock(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t hours, uint16_t minutes, uint16_t seconds, uint16_t millisecs);
+void EVE_cached_dial(int16_t x0, int16_t y0, int16_t r0, uint16_t options, uint16_t val);
+void EVE_cached_keys(int16_t x0, int16_t y0, int16_t w0, int16_t h0, int16_t font, uint16_t options, const char* text);
+
+#endif /* EVE_WIDGET_CACHE_H_ */
@@ -0,0 +1,173 @@
+/*
+@file    EVE_asset.c
+@brief   what the host tools share for the assets on their command line: formats, name:FORMAT:file[:WIDTHxHEIGHT] and reading files
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "EVE_asset.h"
+#include "EVE_image.h"
+
+
+static const EVE_asset_format_t formats[] =
+{
+	{"L1", "EVE_L1", EVE_IMAGE_L1, 0},
+	{"L2", "EVE_L2", EVE_IMAGE_L2, 0},
+	{"L4", "EVE_L4", EVE_IMAGE_L4, 0},
+	{"L8", "EVE_L8", EVE_IMAGE_L8, 1},
+	{"RGB565", "EVE_RGB565", EVE_IMAGE_RGB565, 2},
+	{"ARGB1555", "EVE_ARGB1555", EVE_IMAGE_ARGB1555, 0},
+	{"ARGB4", "EVE_ARGB4", EVE_IMAGE_ARGB4, 2},
+	{"PALETTED", "EVE_PALETTED", EVE_IMAGE_PALETTED, 0},
+	{"PALETTED8", "EVE_PALETTED8", EVE_IMAGE_PALETTED8, 0},
+	{"RAW", NULL, EVE_IMAGE_RAW, 0},
+};
+
+
+const EVE_asset_format_t *EVE_asset_format(uint8_t format)
+{
+	size_t index;
+
+	for(index = 0; index < (sizeof(formats) / sizeof(formats[0])); index++)
+	{
+		if(formats[index].format == format)
+		{
+			return &formats[index];
+		}
+	}
+
+	return NULL;
+}
+
+
+/* name:FORMAT:file[:WIDTHxHEIGHT], PALETTED is replaced by the paletted format of the chip, l2 is 0 for chips without L2 */
+int EVE_asset_parse(const char *spec, uint8_t paletted, uint8_t l2, EVE_asset_spec_t *asset)
+{
+	char buffer[640];
+	char *field[4] = {NULL, NULL, NULL, NULL};
+	char *next;
+	size_t index;
+	int count = 0;
+
+	if(strlen(spec) >= sizeof(buffer))
+	{
+		return -1;
+	}
+
+	strcpy(buffer, spec);
+	next = buffer;
+
+	while((next != NULL) && (count < 4))
+	{
+		field[count++] = next;
+		next = strchr(next, ':');
+
+		if(next != NULL)
+		{
+			*next++ = 0;
+		}
+	}
+
+	if((count < 3) || (strlen(field[0]) >= sizeof(asset->name)) || (strlen(field[2]) >= sizeof(asset->path)))
+	{
+		return -1;
+	}
+
+	memset(asset, 0, sizeof(EVE_asset_spec_t));
+	strcpy(asset->name, field[0]);
+	strcpy(asset->path, field[2]);
+
+	for(index = 0; asset->name[index] != 0; index++)
+	{
+		if((isalnum((unsigned char) asset->name[index]) == 0) && (asset->name[index] != '_'))
+		{
+			return -1;
+		}
+	}
+
+	for(index = 0; index < (sizeof(formats) / sizeof(formats[0])); index++)
+	{
+		if(strcmp(field[1], formats[index].name) == 0)
+		{
+			asset->format = formats[index].format;
+			break;
+		}
+	}
+
+	if(index == (sizeof(formats) / sizeof(formats[0])))
+	{
+		fprintf(stderr, "%s: unknown format %s\n", asset->name, field[1]);
+		return -1;
+	}
+
+	if(asset->format == EVE_IMAGE_PALETTED)
+	{
+		asset->format = paletted;
+	}
+
+	if((asset->format == EVE_IMAGE_L2) && (l2 == 0))
+	{
+		fprintf(stderr, "%s: L2 needs a BT81x\n", asset->name);
+		return -1;
+	}
+
+	if(field[3] != NULL)
+	{
+		if(sscanf(field[3], "%ux%u", &asset->width, &asset->height) != 2)
+		{
+			return -1;
+		}
+
+		asset->as_is = 1;
+	}
+
+	return 0;
+}
+
+
+/* the whole file in a buffer from malloc(), NULL if it can not be read */
+uint8_t *EVE_asset_read(const char *path, uint32_t *size)
+{
+	FILE *file = fopen(path, "rb");
+	uint8_t *data = NULL;
+	long length;
+
+	if(file == NULL)
+	{
+		perror(path);
+		return NULL;
+	}
+
+	if((fseek(file, 0, SEEK_END) == 0) && ((length = ftell(file)) >= 0) && (length <= 0xFFFFFFFFL) && (fseek(file, 0, SEEK_SET) == 0))
+	{
+		data = malloc((length != 0) ? (size_t) length : 1);
+
+		if((data != NULL) && (fread(data, 1, (size_t) length, file) != (size_t) length))
+		{
+			free(data);
+			data = NULL;
+		}
+
+		*size = (uint32_t) length;
+	}
+
+	if(data == NULL)
+	{
+		fprintf(stderr, "%s: read failed\n", path);
+	}
+
+	fclose(file);
+	return data;
+}
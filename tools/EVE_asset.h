@@ -0,0 +1,42 @@
+/*
+@file    EVE_asset.h
+@brief   what the host tools share for the assets on their command line: formats, name:FORMAT:file[:WIDTHxHEIGHT] and reading files
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_ASSET_H_
+#define EVE_ASSET_H_
+
+#include <stdint.h>
+
+typedef struct
+{
+	const char *name;
+	const char *define;	/* the define of the EVE library, NULL for RAW */
+	uint8_t format;		/* EVE_IMAGE_... */
+	uint8_t bytes;		/* per pixel for the formats CMD_LOADIMAGE writes, 0 for all others */
+} EVE_asset_format_t;
+
+typedef struct
+{
+	char name[64];
+	char path[512];
+	uint8_t format;
+	uint8_t as_is;		/* WIDTHxHEIGHT was given, the file already is in the target format */
+	uint32_t width;
+	uint32_t height;
+} EVE_asset_spec_t;
+
+const EVE_asset_format_t *EVE_asset_format(uint8_t format);
+int EVE_asset_parse(const char *spec, uint8_t paletted, uint8_t l2, EVE_asset_spec_t *asset);
+uint8_t *EVE_asset_read(const char *path, uint32_t *size);
+
+#endif /* EVE_ASSET_H_ */
@@ -0,0 +1,160 @@
+/*
+@file    EVE_convert_bench.c
+@brief   measures the pixel conversion kernels of EVE_convert.c on the host
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+eve_convert_bench [width height [rounds]]
+
+Converts a generated frame with every format and source, once with the scalar kernels and once with
+the kernels that were selected when compiling, checks that both give the same bytes and prints the
+throughput in megapixels per second. The dithered conversions are listed as well for comparison.
+Build with "make SIMD_FLAGS=-mavx2" or "make SIMD_FLAGS=-march=native" to get the AVX2 kernels on x86.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "EVE.h"
+#include "EVE_convert.h"
+
+static uint64_t bench_sink;
+
+/* EVE_convert_upload() is not used here, this only satisfies the linker */
+void EVE_memWrite_sram_buffer(uint32_t ftAddress, const uint8_t *data, uint16_t len)
+{
+	bench_sink += ftAddress + len + data[0];
+}
+
+static double bench_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec + ((double) now.tv_nsec / 1e9);
+}
+
+static double bench_run(EVE_convert_t *conv, uint8_t *dst, const uint8_t *src, uint32_t height, uint32_t rounds)
+{
+	double start = bench_now();
+	uint32_t round, line;
+
+	for(round = 0; round < rounds; round++)
+	{
+		EVE_convert_restart(conv);
+
+		for(line = 0; line < height; line++)
+		{
+			EVE_convert_line(conv, dst + (line * conv->stride), src + (line * conv->width * conv->source));
+		}
+	}
+
+	return ((double) conv->width * height * rounds) / ((bench_now() - start) * 1e6);
+}
+
+int main(int argc, char *argv[])
+{
+	static const struct
+	{
+		uint8_t format;
+		const char *name;
+	} formats[] =
+	{
+		{ EVE_RGB565, "RGB565" },
+		{ EVE_ARGB1555, "ARGB1555" },
+		{ EVE_ARGB4, "ARGB4" },
+		{ EVE_L8, "L8" },
+		{ EVE_L4, "L4" },
+	};
+	static const uint8_t sources[] = { EVE_CONVERT_RGB888, EVE_CONVERT_RGBA8888 };
+	uint32_t width = 800;
+	uint32_t height = 480;
+	uint32_t rounds = 20;
+	uint8_t *src, *reference, *dst;
+	int16_t *errors;
+	EVE_convert_t conv;
+	double scalar, simd, ordered, diffusion;
+	size_t index, format, source;
+	int rc = 0;
+
+	if(argc >= 3)
+	{
+		width = (uint32_t) strtoul(argv[1], NULL, 0);
+		height = (uint32_t) strtoul(argv[2], NULL, 0);
+	}
+
+	if(argc >= 4)
+	{
+		rounds = (uint32_t) strtoul(argv[3], NULL, 0);
+	}
+
+	if((width == 0) || (width > 0xFFFF) || (height == 0) || (rounds == 0))
+	{
+		fprintf(stderr, "usage: %s [width height [rounds]]\n", argv[0]);
+		return 2;
+	}
+
+	src = malloc((size_t) width * height * 4);
+	reference = malloc((size_t) width * height * 2);
+	dst = malloc((size_t) width * height * 2);
+	errors = malloc(EVE_CONVERT_ERRORS(width) * sizeof(int16_t));
+
+	if((src == NULL) || (reference == NULL) || (dst == NULL) || (errors == NULL))
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	srand(1);
+	for(index = 0; index < ((size_t) width * height * 4); index++)
+	{
+		src[index] = (uint8_t) rand();
+	}
+
+	printf("%ux%u, %u rounds, MP/s\n", width, height, rounds);
+	printf("%-9s %-9s %9s %9s %-7s %9s %9s\n", "format", "source", "scalar", "simd", "kernel", "ordered", "diffusion");
+
+	for(format = 0; format < (sizeof(formats) / sizeof(formats[0])); format++)
+	{
+		for(source = 0; source < sizeof(sources); source++)
+		{
+			EVE_convert_init(&conv, formats[format].format, sources[source], (uint16_t) width, EVE_CONVERT_SCALAR, NULL);
+			scalar = bench_run(&conv, reference, src, height, rounds);
+
+			EVE_convert_init(&conv, formats[format].format, sources[source], (uint16_t) width, 0, NULL);
+			memset(dst, 0, (size_t) width * height * 2);
+			simd = bench_run(&conv, dst, src, height, rounds);
+
+			if(memcmp(dst, reference, (size_t) conv.stride * height) != 0)
+			{
+				fprintf(stderr, "%s from %u bytes per pixel: the %s kernel differs from the scalar kernel\n", formats[format].name, sources[source], conv.kernel_name);
+				rc = 1;
+			}
+
+			printf("%-9s %-9s %9.1f %9.1f %-7s", formats[format].name, (sources[source] == EVE_CONVERT_RGB888) ? "RGB888" : "RGBA8888", scalar, simd, conv.kernel_name);
+
+			EVE_convert_init(&conv, formats[format].format, sources[source], (uint16_t) width, EVE_DITHER_ORDERED, NULL);
+			ordered = bench_run(&conv, dst, src, height, rounds);
+
+			EVE_convert_init(&conv, formats[format].format, sources[source], (uint16_t) width, EVE_DITHER_DIFFUSION, errors);
+			diffusion = bench_run(&conv, dst, src, height, rounds);
+
+			printf(" %9.1f %9.1f\n", ordered, diffusion);
+		}
+	}
+
+	free(src);
+	free(reference);
+	free(dst);
+	free(errors);
+	return rc;
+}
@@ -0,0 +1,252 @@
+/*
+@file    EVE_deflate.c
+@brief   zlib streams for CMD_INFLATE, compressed in independent blocks by a pool of threads
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+CMD_INFLATE takes any zlib stream, so this always goes for the smallest one zlib can produce:
+level 9 with memLevel 9 and the full 32k window, and every block is compressed with the default,
+the filtered and the run-length strategy of which the shortest result is kept.
+
+The data is split into blocks that are compressed at the same time as raw deflate data.
+Every block but the last ends with a sync flush which puts it on a byte boundary, so the blocks
+can simply be concatenated behind the zlib header, the Adler-32 of the whole data goes behind the last block.
+A block is primed with the last 32k of data in front of it as a dictionary, which is possible since
+all of the data is known up front, so the matches can still reach back into the previous block
+and the stream is only a few bytes per block longer than a stream compressed in one piece.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "EVE_deflate.h"
+
+
+typedef struct
+{
+	const uint8_t *data;
+	uint32_t size;
+	uint32_t block;
+	uint32_t blocks;
+	uint32_t next;
+	uint8_t **packed;
+	uint32_t *packed_size;
+	int error;
+	pthread_mutex_t lock;
+} EVE_deflate_job_t;
+
+
+/* raw deflate data for one block, returns NULL when zlib fails */
+static uint8_t *EVE_deflate_block(const uint8_t *data, uint32_t offset, uint32_t length, int last, uint32_t *packed_size)
+{
+	static const int strategies[] = { Z_DEFAULT_STRATEGY, Z_FILTERED, Z_RLE };
+	uint32_t dictionary = (offset < EVE_DEFLATE_WINDOW) ? offset : EVE_DEFLATE_WINDOW;
+	uint8_t *best = NULL;
+	uint8_t *packed;
+	uLong bound;
+	z_stream stream;
+	size_t index;
+	int result;
+
+	for(index = 0; index < (sizeof(strategies) / sizeof(strategies[0])); index++)
+	{
+		memset(&stream, 0, sizeof(stream));
+
+		if(deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 9, strategies[index]) != Z_OK)
+		{
+			break;
+		}
+
+		/* the bound is for a finished stream, a sync flush adds up to 5 bytes more */
+		bound = deflateBound(&stream, length) + 16;
+		packed = malloc(bound);
+
+		if((dictionary != 0) && (packed != NULL))
+		{
+			deflateSetDictionary(&stream, data + offset - dictionary, dictionary);
+		}
+
+		result = Z_STREAM_ERROR;
+
+		if(packed != NULL)
+		{
+			stream.next_in = (Bytef *) (data + offset);
+			stream.avail_in = length;
+			stream.next_out = packed;
+			stream.avail_out = (uInt) bound;
+			result = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+		}
+
+		if((result == (last ? Z_STREAM_END : Z_OK)) && (stream.avail_in == 0) && ((best == NULL) || (stream.total_out < *packed_size)))
+		{
+			free(best);
+			best = packed;
+			*packed_size = (uint32_t) stream.total_out;
+		}
+		else
+		{
+			free(packed);
+		}
+
+		deflateEnd(&stream);
+	}
+
+	return best;
+}
+
+
+static void *EVE_deflate_worker(void *arg)
+{
+	EVE_deflate_job_t *job = arg;
+	uint32_t index, offset, length;
+
+	for(;;)
+	{
+		pthread_mutex_lock(&job->lock);
+		index = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if(index >= job->blocks)
+		{
+			return NULL;
+		}
+
+		offset = index * job->block;
+		length = ((job->size - offset) < job->block) ? (job->size - offset) : job->block;
+		job->packed[index] = EVE_deflate_block(job->data, offset, length, index == (job->blocks - 1), &job->packed_size[index]);
+
+		if(job->packed[index] == NULL)
+		{
+			job->error = 1;
+		}
+	}
+}
+
+
+/* returns a zlib stream for EVE_cmd_inflate() that needs to be freed, or NULL */
+/* block is the number of bytes compressed as one, 0 for EVE_DEFLATE_BLOCK, jobs is the number of threads */
+uint8_t *EVE_deflate(const uint8_t *data, uint32_t size, uint32_t *packed_size, uint32_t block, unsigned jobs)
+{
+	EVE_deflate_job_t job;
+	pthread_t *threads = NULL;
+	uint8_t *stream = NULL;
+	uint32_t adler, length, index;
+	unsigned thread;
+
+	if(block == 0)
+	{
+		block = EVE_DEFLATE_BLOCK;
+	}
+
+	memset(&job, 0, sizeof(job));
+	job.data = data;
+	job.size = size;
+	job.block = block;
+	job.blocks = (size == 0) ? 1 : ((size + block - 1) / block);
+	job.packed = calloc(job.blocks, sizeof(uint8_t *));
+	job.packed_size = calloc(job.blocks, sizeof(uint32_t));
+	pthread_mutex_init(&job.lock, NULL);
+
+	if((job.packed == NULL) || (job.packed_size == NULL))
+	{
+		job.error = 1;
+	}
+	else
+	{
+		if(jobs > job.blocks)
+		{
+			jobs = job.blocks;
+		}
+
+		if(jobs > 1)
+		{
+			threads = malloc(jobs * sizeof(pthread_t));
+		}
+
+		if(threads == NULL)
+		{
+			EVE_deflate_worker(&job);
+		}
+		else
+		{
+			for(thread = 0; thread < jobs; thread++)
+			{
+				pthread_create(&threads[thread], NULL, EVE_deflate_worker, &job);
+			}
+
+			for(thread = 0; thread < jobs; thread++)
+			{
+				pthread_join(threads[thread], NULL);
+			}
+
+			free(threads);
+		}
+	}
+
+	if(job.error == 0)
+	{
+		length = 2 + 4;
+
+		for(index = 0; index < job.blocks; index++)
+		{
+			length += job.packed_size[index];
+		}
+
+		stream = malloc(length);
+	}
+
+	if(stream != NULL)
+	{
+		/* deflate with a 32k window, maximum compression, the check bits make 0x78DA a multiple of 31 */
+		stream[0] = 0x78;
+		stream[1] = 0xDA;
+		length = 2;
+
+		for(index = 0; index < job.blocks; index++)
+		{
+			memcpy(&stream[length], job.packed[index], job.packed_size[index]);
+			length += job.packed_size[index];
+		}
+
+		adler = (uint32_t) adler32(adler32(0L, Z_NULL, 0), data, size);
+		stream[length++] = (uint8_t) (adler >> 24);
+		stream[length++] = (uint8_t) (adler >> 16);
+		stream[length++] = (uint8_t) (adler >> 8);
+		stream[length++] = (uint8_t) adler;
+		*packed_size = length;
+	}
+
+	if(job.packed != NULL)
+	{
+		for(index = 0; index < job.blocks; index++)
+		{
+			free(job.packed[index]);
+		}
+	}
+
+	free(job.packed);
+	free(job.packed_size);
+	pthread_mutex_destroy(&job.lock);
+	return stream;
+}
+
+
+/* seconds to clock bytes over the bus, lanes is 1 for SPI, 2 or 4 for the dual and quad modes of the FT81x and BT81x */
+double EVE_deflate_bus_time(uint32_t bytes, uint32_t spi_hz, uint8_t lanes)
+{
+	if((spi_hz == 0) || (lanes == 0))
+	{
+		return 0.0;
+	}
+
+	return ((double) bytes * 8.0) / ((double) spi_hz * lanes);
+}
@@ -0,0 +1,26 @@
+/*
+@file    EVE_deflate.h
+@brief   zlib streams for CMD_INFLATE, compressed in independent blocks by a pool of threads
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_DEFLATE_H_
+#define EVE_DEFLATE_H_
+
+#include <stdint.h>
+
+#define EVE_DEFLATE_BLOCK	131072UL	/* default for the bytes per block */
+#define EVE_DEFLATE_WINDOW	32768UL		/* the blocks are primed with that much of the data before them */
+
+uint8_t *EVE_deflate(const uint8_t *data, uint32_t size, uint32_t *packed_size, uint32_t block, unsigned jobs);
+double EVE_deflate_bus_time(uint32_t bytes, uint32_t spi_hz, uint8_t lanes);
+
+#endif /* EVE_DEFLATE_H_ */
@@ -0,0 +1,208 @@
+/*
+@file    EVE_deflate_main.c
+@brief   command line front end for EVE_deflate.c
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+eve_deflate [options] input [output]
+
+-j jobs     number of threads, default is the number of cores
+-b bytes    bytes per independent block, default is 131072
+-s hz       SPI clock for the estimate of the transfer time, default is 20000000
+-l lanes    1 for SPI, 2 or 4 for dual or quad SPI, default is 1
+-c name     write a C array with that name instead of the binary stream
+
+The output defaults to input.z, or input.c with -c.
+The stream is checked by inflating it again before it is written.
+
+eve_deflate -s 30000000 -l 4 -c logo logo.bin
+
+@section History
+
+4.1
+- first version
+- reading the file is in EVE_asset.c
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "EVE_asset.h"
+#include "EVE_deflate.h"
+
+
+/* inflate the stream again and compare */
+static int EVE_deflate_verify(const uint8_t *data, uint32_t size, const uint8_t *packed, uint32_t packed_size)
+{
+	uLongf length = size;
+	uint8_t *check = malloc((size != 0) ? size : 1);
+	int result;
+
+	if(check == NULL)
+	{
+		return -1;
+	}
+
+	result = uncompress(check, &length, packed, packed_size);
+
+	if((result != Z_OK) || (length != size) || (memcmp(check, data, size) != 0))
+	{
+		result = -1;
+	}
+
+	free(check);
+	return result;
+}
+
+
+static int EVE_deflate_write(const char *path, const char *name, const uint8_t *packed, uint32_t packed_size)
+{
+	FILE *file = fopen(path, name ? "w" : "wb");
+	uint32_t index;
+
+	if(file == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	if(name == NULL)
+	{
+		fwrite(packed, 1, packed_size, file);
+	}
+	else
+	{
+		fprintf(file, "/* generated by eve_deflate, upload with EVE_cmd_inflate(address, %s, %uUL); */\n\n", name, packed_size);
+		fprintf(file, "#include <stdint.h>\n\n");
+		fprintf(file, "const uint8_t %s[%u] =\n{", name, packed_size);
+
+		for(index = 0; index < packed_size; index++)
+		{
+			fprintf(file, "%s0x%02X%s", ((index % 16) == 0) ? "\n\t" : "", packed[index], (index != (packed_size - 1)) ? ", " : "");
+		}
+
+		fprintf(file, "\n};\n");
+	}
+
+	if(fclose(file) != 0)
+	{
+		perror(path);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static void EVE_deflate_usage(void)
+{
+	fprintf(stderr, "usage: eve_deflate [-j jobs] [-b bytes] [-s hz] [-l lanes] [-c name] input [output]\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char *name = NULL;
+	char *output;
+	uint8_t *data, *packed;
+	uint32_t size, packed_size = 0, block = EVE_DEFLATE_BLOCK, spi_hz = 20000000UL;
+	uint8_t lanes = 1;
+	double raw_time, packed_time;
+	long jobs;
+	int option;
+
+	jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+	while((option = getopt(argc, argv, "j:b:s:l:c:h")) != -1)
+	{
+		switch(option)
+		{
+			case 'j':
+				jobs = strtol(optarg, NULL, 0);
+				break;
+
+			case 'b':
+				block = (uint32_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 's':
+				spi_hz = (uint32_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'l':
+				lanes = (uint8_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'c':
+				name = optarg;
+				break;
+
+			default:
+				EVE_deflate_usage();
+				return 1;
+		}
+	}
+
+	if(((argc - optind) < 1) || ((argc - optind) > 2) || (spi_hz == 0) || ((lanes != 1) && (lanes != 2) && (lanes != 4)))
+	{
+		EVE_deflate_usage();
+		return 1;
+	}
+
+	if(jobs < 1)
+	{
+		jobs = 1;
+	}
+
+	data = EVE_asset_read(argv[optind], &size);
+
+	if(data == NULL)
+	{
+		return 1;
+	}
+
+	packed = EVE_deflate(data, size, &packed_size, block, (unsigned) jobs);
+
+	if((packed == NULL) || (EVE_deflate_verify(data, size, packed, packed_size) != 0))
+	{
+		fprintf(stderr, "%s: deflate failed\n", argv[optind]);
+		return 1;
+	}
+
+	if((argc - optind) == 2)
+	{
+		output = strdup(argv[optind + 1]);
+	}
+	else
+	{
+		output = malloc(strlen(argv[optind]) + 3);
+
+		if(output != NULL)
+		{
+			sprintf(output, "%s.%s", argv[optind], name ? "c" : "z");
+		}
+	}
+
+	if((output == NULL) || (EVE_deflate_write(output, name, packed, packed_size) != 0))
+	{
+		return 1;
+	}
+
+	/* CMD_INFLATE needs the stream padded to four bytes in the FIFO */
+	raw_time = EVE_deflate_bus_time(size, spi_hz, lanes);
+	packed_time = EVE_deflate_bus_time((packed_size + 3) & ~3UL, spi_hz, lanes);
+
+	printf("%s: %u bytes, %u packed, %.1f%%\n", output, size, packed_size, (size != 0) ? (100.0 * packed_size / size) : 0.0);
+	printf("at %.1f MHz with %u lane%s: %.2f ms raw, %.2f ms packed, %.2f ms saved on the bus\n", spi_hz / 1e6, lanes, (lanes > 1) ? "s" : "",
+		raw_time * 1e3, packed_time * 1e3, (raw_time - packed_time) * 1e3);
+
+	free(output);
+	free(packed);
+	free(data);
+	return 0;
+}
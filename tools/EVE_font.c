@@ -0,0 +1,650 @@
+/*
+@file    EVE_font.c
+@brief   font converter, rasterizes the characters an application uses to a font for EVE_font_load()
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+eve_font [options] font
+
+-n name     name of the array and the defines, default is "font"
+-o name     base name of the generated files, default is the name
+-p pixels   size of the font in pixels, for bitmap fonts the strike that is closest, default is 20
+-f FORMAT   L1, L2, L4 or L8, default is L4, L2 needs a BT81x
+-c chars    put these characters into the font
+-s file     put the characters of the string literals in this C source into the font, can be given more than once
+-r first-last  put this range of characters into the font, default is 32-126 when neither -c nor -s is given
+-u          do not deflate the data, it is uploaded with EVE_memWrite_flash_buffer() then
+
+The font is read with FreeType, so it can be TTF, OTF, BDF, PCF or anything else FreeType knows.
+The font metric block only has widths for the characters 0 to 127 and the glyphs need to follow each other
+from the first character on, so the font covers the range from the lowest to the highest character that is used.
+The characters in that range that are not used get an empty glyph and a width of 0, these take space in RAM_G
+but deflate to almost nothing.
+Characters outside of 32 to 126 are ignored, -s only looks at the strings, not at the comments or the code.
+
+eve_font -n dialog -p 24 -f L4 -s tft.c DejaVuSans.ttf
+
+generates dialog.h:
+
+#define DIALOG_FIRSTCHAR	32
+#define DIALOG_HEIGHT	28
+#define DIALOG_SIZE	20308UL
+#define DIALOG_LENGTH	5517UL
+extern const uint8_t dialog[5517] PROGMEM;
+
+and dialog.c with the array that is loaded with:
+EVE_font_load(12, MEM_DIALOG, dialog, DIALOG_LENGTH, DIALOG_FIRSTCHAR);
+
+DIALOG_SIZE is the space it needs in RAM_G.
+
+@section History
+
+4.1
+- first version
+- names for -n are limited to 63 characters
+
+*/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include "EVE_deflate.h"
+#include "EVE_image.h"
+
+
+#define EVE_FONT_CHARS		128		/* the metric block has widths for these */
+#define EVE_FONT_METRICS	148UL
+#define EVE_FONT_FIRST		32
+#define EVE_FONT_LAST		126
+#define EVE_FONT_NAME		64		/* -n is shorter than this */
+
+typedef struct
+{
+	const char *name;
+	uint8_t format;
+	uint8_t bits;
+} EVE_font_format_t;
+
+static const EVE_font_format_t formats[] =
+{
+	{"L1", EVE_IMAGE_L1, 1},
+	{"L2", EVE_IMAGE_L2, 2},
+	{"L4", EVE_IMAGE_L4, 4},
+	{"L8", EVE_IMAGE_L8, 8},
+};
+
+typedef struct
+{
+	uint8_t used;
+	uint8_t advance;
+	int32_t left;
+	int32_t top;
+	uint32_t width;
+	uint32_t rows;
+	uint8_t *coverage;	/* rows * width, 0 to 255 */
+} EVE_glyph_t;
+
+static EVE_glyph_t glyphs[EVE_FONT_CHARS];
+
+
+static void EVE_font_add(const char *chars)
+{
+	while(*chars != 0)
+	{
+		if((*chars >= EVE_FONT_FIRST) && (*chars <= EVE_FONT_LAST))
+		{
+			glyphs[(uint8_t) *chars].used = 1;
+		}
+
+		chars++;
+	}
+}
+
+
+/* the value of an escape sequence, text points behind the backslash and is moved past the sequence */
+static int EVE_font_escape(const char **text)
+{
+	const char *next = *text;
+	int value = 0;
+	int count;
+
+	switch(*next)
+	{
+		case 'n':
+			value = '\n';
+			break;
+		case 't':
+			value = '\t';
+			break;
+		case 'r':
+			value = '\r';
+			break;
+		case 'x':
+			for(next++; isxdigit((unsigned char) *next); next++)
+			{
+				value = (value * 16) + (isdigit((unsigned char) *next) ? (*next - '0') : ((tolower((unsigned char) *next) - 'a') + 10));
+			}
+
+			*text = next;
+			return value;
+		default:
+			if((*next >= '0') && (*next <= '7'))
+			{
+				for(count = 0; (count < 3) && (*next >= '0') && (*next <= '7'); count++, next++)
+				{
+					value = (value * 8) + (*next - '0');
+				}
+
+				*text = next;
+				return value;
+			}
+
+			value = (unsigned char) *next; /* \\ \" \' and the ones that do not matter here */
+			break;
+	}
+
+	*text = next + 1;
+	return value;
+}
+
+
+/* marks the characters of all the string literals in a C source as used */
+static int EVE_font_source(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	char *text;
+	const char *next;
+	long length;
+	int value;
+
+	if(file == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	fseek(file, 0, SEEK_END);
+	length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	text = malloc((length > 0) ? (size_t) length + 1 : 1);
+
+	if((text == NULL) || (fread(text, 1, (size_t) length, file) != (size_t) length))
+	{
+		fclose(file);
+		free(text);
+		return -1;
+	}
+
+	fclose(file);
+	text[length] = 0;
+	next = text;
+
+	while(*next != 0)
+	{
+		if((next[0] == '/') && (next[1] == '/'))
+		{
+			next = strchr(next, '\n');
+			next = (next != NULL) ? next : "";
+		}
+		else if((next[0] == '/') && (next[1] == '*'))
+		{
+			next = strstr(next + 2, "*/");
+			next = (next != NULL) ? (next + 2) : "";
+		}
+		else if(*next == '\'') /* character constants are not strings, skip them */
+		{
+			for(next++; (*next != 0) && (*next != '\''); )
+			{
+				next += (*next == '\\') ? ((next[1] != 0) ? 2 : 1) : 1;
+			}
+
+			next += (*next != 0) ? 1 : 0;
+		}
+		else if(*next == '"')
+		{
+			for(next++; (*next != 0) && (*next != '"') && (*next != '\n'); )
+			{
+				if(*next == '\\')
+				{
+					next++;
+					value = EVE_font_escape(&next);
+				}
+				else
+				{
+					value = (unsigned char) *next++;
+				}
+
+				if((value >= EVE_FONT_FIRST) && (value <= EVE_FONT_LAST))
+				{
+					glyphs[value].used = 1;
+				}
+			}
+
+			next += (*next == '"') ? 1 : 0;
+		}
+		else
+		{
+			next++;
+		}
+	}
+
+	free(text);
+	return 0;
+}
+
+
+/* copies the glyph FreeType rendered to a coverage map with one byte per pixel */
+static int EVE_font_glyph(FT_Face face, uint8_t character, EVE_glyph_t *glyph, uint8_t mono)
+{
+	FT_Bitmap *bitmap;
+	uint32_t x, y;
+	uint8_t value;
+
+	if(FT_Load_Char(face, character, FT_LOAD_RENDER | (mono ? (FT_LOAD_TARGET_MONO | FT_LOAD_MONOCHROME) : FT_LOAD_TARGET_NORMAL)) != 0)
+	{
+		return -1;
+	}
+
+	bitmap = &face->glyph->bitmap;
+	glyph->advance = (uint8_t) (((face->glyph->advance.x + 32) >> 6) > 255 ? 255 : ((face->glyph->advance.x + 32) >> 6));
+	glyph->left = face->glyph->bitmap_left;
+	glyph->top = face->glyph->bitmap_top;
+	glyph->width = bitmap->width;
+	glyph->rows = bitmap->rows;
+	glyph->coverage = calloc((size_t) (bitmap->width * bitmap->rows) + 1, 1);
+
+	if(glyph->coverage == NULL)
+	{
+		return -1;
+	}
+
+	for(y = 0; y < bitmap->rows; y++)
+	{
+		for(x = 0; x < bitmap->width; x++)
+		{
+			if(bitmap->pixel_mode == FT_PIXEL_MODE_MONO)
+			{
+				value = ((bitmap->buffer[(y * bitmap->pitch) + (x / 8)] >> (7 - (x % 8))) & 1) ? 255 : 0;
+			}
+			else if(bitmap->pixel_mode == FT_PIXEL_MODE_GRAY)
+			{
+				value = (uint8_t) ((bitmap->buffer[(y * bitmap->pitch) + x] * 255) / (bitmap->num_grays - 1));
+			}
+			else
+			{
+				return -1;
+			}
+
+			glyph->coverage[(y * glyph->width) + x] = value;
+		}
+	}
+
+	return 0;
+}
+
+
+/* puts a pixel with the coverage value into a line of the glyph in the format */
+static void EVE_font_pixel(uint8_t *line, uint32_t x, uint8_t bits, uint8_t value)
+{
+	uint8_t level = (uint8_t) (((value * ((1U << bits) - 1U)) + 127U) / 255U);
+	uint8_t per_byte = (uint8_t) (8 / bits);
+	uint8_t shift = (uint8_t) (8 - (((x % per_byte) + 1) * bits)); /* the leftmost pixel is in the upper bits */
+
+	line[x / per_byte] |= (uint8_t) (level << shift);
+}
+
+
+static void EVE_font_upper(const char *name, char *upper)
+{
+	while(*name != 0)
+	{
+		*upper++ = (char) toupper((unsigned char) *name++);
+	}
+
+	*upper = 0;
+}
+
+
+static void EVE_font_put32(uint8_t *data, uint32_t value)
+{
+	data[0] = (uint8_t) value;
+	data[1] = (uint8_t) (value >> 8);
+	data[2] = (uint8_t) (value >> 16);
+	data[3] = (uint8_t) (value >> 24);
+}
+
+
+static int EVE_font_write(const char *base, const char *name, const char *font, const EVE_font_format_t *format,
+	uint8_t first, uint32_t height, uint32_t size, const uint8_t *data, uint32_t length, int deflated)
+{
+	char path[600];
+	char upper[EVE_FONT_NAME];
+	FILE *header, *source;
+	uint32_t index;
+
+	EVE_font_upper(name, upper);
+	snprintf(path, sizeof(path), "%s.h", base);
+	header = fopen(path, "w");
+	snprintf(path, sizeof(path), "%s.c", base);
+	source = fopen(path, "w");
+
+	if((header == NULL) || (source == NULL))
+	{
+		perror(path);
+		return -1;
+	}
+
+	fprintf(header, "/* generated by eve_font from %s, do not edit */\n\n", font);
+	fprintf(header, "#ifndef %s_H_\n#define %s_H_\n\n", upper, upper);
+	fprintf(header, "#if defined (__AVR__)\n\t#include <avr/pgmspace.h>\n#else\n\t#define PROGMEM\n#endif\n\n");
+	fprintf(header, "/* %s, %s, load with EVE_font_load(font, address, %s, %s_LENGTH, %s_FIRSTCHAR) */\n", format->name,
+		deflated ? "deflated" : "not deflated", name, upper, upper);
+	fprintf(header, "#define %s_FIRSTCHAR\t%u\n", upper, first);
+	fprintf(header, "#define %s_HEIGHT\t%u\n", upper, height);
+	fprintf(header, "#define %s_SIZE\t%uUL\n", upper, size);
+	fprintf(header, "#define %s_LENGTH\t%uUL\n", upper, length);
+	fprintf(header, "extern const uint8_t %s[%u] PROGMEM;\n\n", name, length);
+	fprintf(header, "#endif /* %s_H_ */\n", upper);
+
+	fprintf(source, "/* generated by eve_font from %s, do not edit */\n\n", font);
+	fprintf(source, "#include <stdint.h>\n\n#if defined (__AVR__)\n\t#include <avr/pgmspace.h>\n#else\n\t#define PROGMEM\n#endif\n\n");
+	fprintf(source, "const uint8_t %s[%u] PROGMEM =\n{\n", name, length);
+
+	for(index = 0; index < length; index++)
+	{
+		fprintf(source, "%s0x%02X,%s", ((index % 16) == 0) ? "\t" : "", data[index], (((index % 16) == 15) || (index == (length - 1))) ? "\n" : " ");
+	}
+
+	fprintf(source, "};\n");
+
+	if((fclose(header) != 0) || (fclose(source) != 0))
+	{
+		perror(base);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static void EVE_font_usage(void)
+{
+	fprintf(stderr, "usage: eve_font [-n name] [-o name] [-p pixels] [-f L1|L2|L4|L8] [-c chars] [-s file] [-r first-last] [-u] font\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	const EVE_font_format_t *format = &formats[2];
+	const char *name = "font";
+	const char *base = NULL;
+	FT_Library library;
+	FT_Face face;
+	EVE_glyph_t *glyph;
+	uint8_t *data, *packed, *line;
+	uint32_t pixels = 20, first_range, last_range;
+	uint32_t width = 0, stride, ascent, height, size, packed_size, full, x, y;
+	int32_t best, distance;
+	int option, index, first = -1, last = -1, selected = 0, deflate_data = 1, count = 0;
+	size_t entry;
+
+	while((option = getopt(argc, argv, "n:o:p:f:c:s:r:uh")) != -1)
+	{
+		switch(option)
+		{
+			case 'n':
+				name = optarg;
+				break;
+
+			case 'o':
+				base = optarg;
+				break;
+
+			case 'p':
+				pixels = (uint32_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'f':
+				format = NULL;
+
+				for(entry = 0; entry < (sizeof(formats) / sizeof(formats[0])); entry++)
+				{
+					if(strcasecmp(optarg, formats[entry].name) == 0)
+					{
+						format = &formats[entry];
+					}
+				}
+
+				if(format == NULL)
+				{
+					EVE_font_usage();
+					return 1;
+				}
+				break;
+
+			case 'c':
+				EVE_font_add(optarg);
+				selected = 1;
+				break;
+
+			case 's':
+				if(EVE_font_source(optarg) != 0)
+				{
+					return 1;
+				}
+
+				selected = 1;
+				break;
+
+			case 'r':
+				if((sscanf(optarg, "%u-%u", &first_range, &last_range) != 2) || (first_range > last_range) || (last_range >= EVE_FONT_CHARS))
+				{
+					EVE_font_usage();
+					return 1;
+				}
+
+				for(; first_range <= last_range; first_range++)
+				{
+					glyphs[first_range].used = (first_range >= EVE_FONT_FIRST) && (first_range <= EVE_FONT_LAST);
+				}
+
+				selected = 1;
+				break;
+
+			case 'u':
+				deflate_data = 0;
+				break;
+
+			default:
+				EVE_font_usage();
+				return 1;
+		}
+	}
+
+	if(((argc - optind) != 1) || (pixels == 0))
+	{
+		EVE_font_usage();
+		return 1;
+	}
+
+	if(strlen(name) >= EVE_FONT_NAME)
+	{
+		fprintf(stderr, "%s: the name is longer than %d characters\n", name, EVE_FONT_NAME - 1);
+		return 1;
+	}
+
+	for(index = 0; name[index] != 0; index++)
+	{
+		if((isalnum((unsigned char) name[index]) == 0) && (name[index] != '_'))
+		{
+			fprintf(stderr, "%s: not a name for C\n", name);
+			return 1;
+		}
+	}
+
+	if(selected == 0)
+	{
+		for(index = EVE_FONT_FIRST; index <= EVE_FONT_LAST; index++)
+		{
+			glyphs[index].used = 1;
+		}
+	}
+
+	for(index = 0; index < EVE_FONT_CHARS; index++)
+	{
+		if(glyphs[index].used)
+		{
+			first = (first < 0) ? index : first;
+			last = index;
+			count++;
+		}
+	}
+
+	if(first < 0)
+	{
+		fprintf(stderr, "no characters to put into the font\n");
+		return 1;
+	}
+
+	if((FT_Init_FreeType(&library) != 0) || (FT_New_Face(library, argv[optind], 0, &face) != 0))
+	{
+		fprintf(stderr, "%s: FreeType can not read this font\n", argv[optind]);
+		return 1;
+	}
+
+	if(FT_IS_SCALABLE(face))
+	{
+		FT_Set_Pixel_Sizes(face, 0, pixels);
+	}
+	else
+	{
+		/* bitmap fonts have fixed sizes, take the one closest to what was asked for */
+		best = 0;
+
+		for(index = 0; index < face->num_fixed_sizes; index++)
+		{
+			distance = abs((int32_t) face->available_sizes[index].height - (int32_t) pixels);
+
+			if(distance < abs((int32_t) face->available_sizes[best].height - (int32_t) pixels))
+			{
+				best = index;
+			}
+		}
+
+		if((face->num_fixed_sizes == 0) || (FT_Select_Size(face, best) != 0))
+		{
+			fprintf(stderr, "%s: no size to select\n", argv[optind]);
+			return 1;
+		}
+	}
+
+	ascent = (uint32_t) ((face->size->metrics.ascender + 63) >> 6);
+	height = ascent + (uint32_t) ((-face->size->metrics.descender + 63) >> 6);
+
+	for(index = first; index <= last; index++)
+	{
+		glyph = &glyphs[index];
+
+		if(glyph->used == 0)
+		{
+			continue;
+		}
+
+		if(EVE_font_glyph(face, (uint8_t) index, glyph, format->bits == 1) != 0)
+		{
+			fprintf(stderr, "%s: no glyph for '%c'\n", argv[optind], index);
+			return 1;
+		}
+
+		/* glyphs that stick out to the left are moved into the cell */
+		glyph->left = (glyph->left < 0) ? 0 : glyph->left;
+		width = ((uint32_t) glyph->left + glyph->width > width) ? ((uint32_t) glyph->left + glyph->width) : width;
+		width = (glyph->advance > width) ? glyph->advance : width;
+	}
+
+	/* the metric block with the glyphs of all the characters from first to last right behind it */
+	stride = EVE_image_stride(format->format, width);
+	size = EVE_FONT_METRICS + ((uint32_t) (last - first + 1) * stride * height);
+	full = EVE_FONT_METRICS + ((EVE_FONT_LAST - EVE_FONT_FIRST + 1) * stride * height);
+	data = calloc(size, 1);
+
+	if(data == NULL)
+	{
+		return 1;
+	}
+
+	for(index = first; index <= last; index++)
+	{
+		glyph = &glyphs[index];
+
+		if(glyph->used == 0)
+		{
+			continue;
+		}
+
+		data[index] = glyph->advance;
+
+		for(y = 0; y < glyph->rows; y++)
+		{
+			int32_t row = (int32_t) ascent - glyph->top + (int32_t) y;
+
+			if((row < 0) || (row >= (int32_t) height))
+			{
+				continue; /* clipped at the top or the bottom of the cell */
+			}
+
+			line = &data[EVE_FONT_METRICS + ((uint32_t) (index - first) * stride * height) + ((uint32_t) row * stride)];
+
+			for(x = 0; x < glyph->width; x++)
+			{
+				EVE_font_pixel(line, (uint32_t) glyph->left + x, format->bits, glyph->coverage[(y * glyph->width) + x]);
+			}
+		}
+
+		free(glyph->coverage);
+	}
+
+	/* the address of the glyphs is set by EVE_font_load(), it depends on where the font is loaded to */
+	EVE_font_put32(&data[128], format->format);
+	EVE_font_put32(&data[132], stride);
+	EVE_font_put32(&data[136], width);
+	EVE_font_put32(&data[140], height);
+	EVE_font_put32(&data[144], 0);
+
+	if(deflate_data)
+	{
+		packed = EVE_deflate(data, size, &packed_size, 0, 1);
+
+		if(packed == NULL)
+		{
+			fprintf(stderr, "deflate failed\n");
+			return 1;
+		}
+	}
+	else
+	{
+		packed = data;
+		packed_size = size;
+	}
+
+	if(EVE_font_write((base != NULL) ? base : name, name, argv[optind], format, (uint8_t) first, height, size, packed, packed_size, deflate_data) != 0)
+	{
+		return 1;
+	}
+
+	printf("%s: %d characters from %d to %d, %ux%u %s, %u bytes in RAM_G, %u to transfer\n", name, count, first, last, width, height,
+		format->name, size, packed_size);
+	printf("all characters from %d to %d would take %u bytes\n", EVE_FONT_FIRST, EVE_FONT_LAST, full);
+
+	FT_Done_Face(face);
+	FT_Done_FreeType(library);
+	return 0;
+}
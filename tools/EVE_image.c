@@ -0,0 +1,593 @@
+/*
+@file    EVE_image.c
+@brief   loading images on the host and converting them to EVE bitmap formats
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+Images are loaded to RGBA8888, PNG with libpng and BMP with 8, 24 or 32 bits per pixel uncompressed.
+For L1, L2, L4 and L8 the luminance is multiplied with the alpha, so that icons with a transparent
+background and grey-scale pictures both come out right.
+The paletted formats use a median-cut over the colors of the image, images with no more than 256 colors
+keep their colors exactly.
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <png.h>
+
+#include "EVE_image.h"
+
+
+int EVE_image_load_png(const char *path, EVE_image_t *image)
+{
+	png_image png;
+
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+
+	if(png_image_begin_read_from_file(&png, path) == 0)
+	{
+		fprintf(stderr, "%s: %s\n", path, png.message);
+		return -1;
+	}
+
+	png.format = PNG_FORMAT_RGBA;
+	image->width = png.width;
+	image->height = png.height;
+	image->pixels = malloc(PNG_IMAGE_SIZE(png));
+
+	if(image->pixels == NULL)
+	{
+		png_image_free(&png);
+		return -1;
+	}
+
+	if(png_image_finish_read(&png, NULL, image->pixels, 0, NULL) == 0)
+	{
+		fprintf(stderr, "%s: %s\n", path, png.message);
+		EVE_image_free(image);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static uint32_t EVE_image_le32(const uint8_t *data)
+{
+	return (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16) | ((uint32_t) data[3] << 24);
+}
+
+
+/* a channel of a 32 bit pixel selected by a BITFIELDS mask and scaled to 8 bits, 0xFF for a mask of 0 */
+static uint8_t EVE_image_channel(uint32_t value, uint32_t mask)
+{
+	uint32_t max;
+
+	if(mask == 0)
+	{
+		return 0xFF;
+	}
+
+	while((mask & 1) == 0)
+	{
+		mask >>= 1;
+		value >>= 1;
+	}
+
+	max = mask;
+	value &= mask;
+	return (uint8_t) (((value * 255UL) + (max / 2)) / max);
+}
+
+
+/* uncompressed BMP with 8, 24 or 32 bits per pixel, 32 bits is read thru the BITFIELDS masks or as BGRX */
+int EVE_image_load_bmp(const char *path, EVE_image_t *image)
+{
+	FILE *file;
+	uint8_t header[54];
+	uint8_t palette[1024];
+	uint8_t fields[16];
+	uint8_t *row = NULL;
+	uint32_t mask[4] = {0x00FF0000UL, 0x0000FF00UL, 0x000000FFUL, 0}; /* red, green, blue and alpha for BI_RGB */
+	uint32_t offset, header_size, compression, colors, stride, x, y, line, value;
+	int32_t width, height;
+	uint16_t bits;
+	const uint8_t *src;
+	uint8_t *dst;
+
+	file = fopen(path, "rb");
+
+	if(file == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	if((fread(header, 1, sizeof(header), file) != sizeof(header)) || (header[0] != 'B') || (header[1] != 'M'))
+	{
+		fprintf(stderr, "%s: not a BMP file\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	offset = EVE_image_le32(&header[10]);
+	header_size = EVE_image_le32(&header[14]);
+	width = (int32_t) EVE_image_le32(&header[18]);
+	height = (int32_t) EVE_image_le32(&header[22]);
+	bits = (uint16_t) (header[28] | (header[29] << 8));
+	compression = EVE_image_le32(&header[30]);
+	colors = EVE_image_le32(&header[46]);
+
+	if((width <= 0) || (height == 0) || ((bits != 8) && (bits != 24) && (bits != 32)) || ((compression != 0) && ((compression != 3) || (bits != 32))))
+	{
+		fprintf(stderr, "%s: only uncompressed BMP with 8, 24 or 32 bits per pixel is supported\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	/* BITFIELDS has the masks right behind the 40 byte header, V4 and V5 headers include these and the mask for alpha as well */
+	if(compression == 3)
+	{
+		memset(fields, 0, sizeof(fields));
+
+		if((fseek(file, 54, SEEK_SET) != 0) || (fread(fields, 1, (header_size >= 56) ? 16 : 12, file) != ((header_size >= 56) ? 16U : 12U)))
+		{
+			fprintf(stderr, "%s: masks are truncated\n", path);
+			fclose(file);
+			return -1;
+		}
+
+		for(x = 0; x < 4; x++)
+		{
+			mask[x] = EVE_image_le32(&fields[x * 4]);
+		}
+	}
+
+	if(bits == 8)
+	{
+		colors = ((colors == 0) || (colors > 256)) ? 256 : colors;
+		memset(palette, 0, sizeof(palette));
+
+		if((fseek(file, 14 + header_size, SEEK_SET) != 0) || (fread(palette, 4, colors, file) != colors))
+		{
+			fprintf(stderr, "%s: palette is truncated\n", path);
+			fclose(file);
+			return -1;
+		}
+	}
+
+	image->width = (uint32_t) width;
+	image->height = (uint32_t) ((height < 0) ? -height : height);
+	stride = (((uint32_t) width * bits / 8) + 3) & ~3U;
+	image->pixels = malloc(image->width * image->height * 4);
+	row = malloc(stride);
+
+	if((image->pixels == NULL) || (row == NULL) || (fseek(file, offset, SEEK_SET) != 0))
+	{
+		free(row);
+		EVE_image_free(image);
+		fclose(file);
+		return -1;
+	}
+
+	for(line = 0; line < image->height; line++)
+	{
+		if(fread(row, 1, stride, file) != stride)
+		{
+			fprintf(stderr, "%s: image data is truncated\n", path);
+			free(row);
+			EVE_image_free(image);
+			fclose(file);
+			return -1;
+		}
+
+		y = (height > 0) ? (image->height - 1 - line) : line; /* positive heights are stored bottom-up */
+		dst = &image->pixels[y * image->width * 4];
+
+		for(x = 0; x < image->width; x++)
+		{
+			if(bits == 32)
+			{
+				value = EVE_image_le32(&row[x * 4]);
+				dst[0] = EVE_image_channel(value, mask[0]);
+				dst[1] = EVE_image_channel(value, mask[1]);
+				dst[2] = EVE_image_channel(value, mask[2]);
+				dst[3] = EVE_image_channel(value, mask[3]);
+				dst += 4;
+				continue;
+			}
+
+			src = (bits == 8) ? &palette[row[x] * 4] : &row[x * 3];
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = 0xFF;
+			dst += 4;
+		}
+	}
+
+	free(row);
+	fclose(file);
+	return 0;
+}
+
+
+/* picks the loader by the extension */
+int EVE_image_load(const char *path, EVE_image_t *image)
+{
+	const char *extension = strrchr(path, '.');
+
+	image->pixels = NULL;
+
+	if((extension != NULL) && ((strcmp(extension, ".bmp") == 0) || (strcmp(extension, ".BMP") == 0)))
+	{
+		return EVE_image_load_bmp(path, image);
+	}
+
+	return EVE_image_load_png(path, image);
+}
+
+
+void EVE_image_free(EVE_image_t *image)
+{
+	free(image->pixels);
+	image->pixels = NULL;
+}
+
+
+void EVE_bitmap_data_free(EVE_bitmap_data_t *bitmap)
+{
+	free(bitmap->data);
+	free(bitmap->palette);
+	bitmap->data = NULL;
+	bitmap->palette = NULL;
+}
+
+
+/* bytes per line for the format, BITMAP_LAYOUT needs this as linestride */
+uint32_t EVE_image_stride(uint8_t format, uint32_t width)
+{
+	switch(format)
+	{
+		case EVE_IMAGE_L1:
+			return (width + 7) / 8;
+		case EVE_IMAGE_L2:
+			return (width + 3) / 4;
+		case EVE_IMAGE_L4:
+			return (width + 1) / 2;
+		case EVE_IMAGE_L8:
+		case EVE_IMAGE_PALETTED:
+		case EVE_IMAGE_PALETTED8:
+			return width;
+		case EVE_IMAGE_ARGB1555:
+		case EVE_IMAGE_ARGB4:
+		case EVE_IMAGE_RGB565:
+			return width * 2;
+		default:
+			return 0;
+	}
+}
+
+
+static uint32_t EVE_image_scale(uint32_t value, uint32_t max)
+{
+	return ((value * max) + 127) / 255;
+}
+
+
+/* the luminance multiplied with the alpha */
+static uint32_t EVE_image_luminance(const uint8_t *pixel)
+{
+	uint32_t luminance = ((pixel[0] * 77U) + (pixel[1] * 150U) + (pixel[2] * 29U) + 128) >> 8;
+
+	return ((luminance * pixel[3]) + 127) / 255;
+}
+
+
+/* median cut */
+
+typedef struct
+{
+	uint32_t color;	/* R in bits 0-7, G in 8-15, B in 16-23, A in 24-31 */
+	uint32_t count;
+	uint32_t index;	/* the palette entry */
+} EVE_color_t;
+
+static int EVE_color_compare(const void *a, const void *b)
+{
+	uint32_t ca = ((const EVE_color_t *) a)->color;
+	uint32_t cb = ((const EVE_color_t *) b)->color;
+
+	return (ca > cb) - (ca < cb);
+}
+
+#define EVE_COLOR_COMPARE(channel) \
+static int EVE_color_compare_##channel(const void *a, const void *b) \
+{ \
+	uint32_t ca = (((const EVE_color_t *) a)->color >> (channel * 8)) & 0xFF; \
+	uint32_t cb = (((const EVE_color_t *) b)->color >> (channel * 8)) & 0xFF; \
+	return (ca > cb) - (ca < cb); \
+}
+
+EVE_COLOR_COMPARE(0)
+EVE_COLOR_COMPARE(1)
+EVE_COLOR_COMPARE(2)
+EVE_COLOR_COMPARE(3)
+
+static int (*const EVE_color_compare_channel[4])(const void *, const void *) =
+{
+	EVE_color_compare_0, EVE_color_compare_1, EVE_color_compare_2, EVE_color_compare_3
+};
+
+typedef struct
+{
+	uint32_t start;
+	uint32_t count;
+	uint32_t range;
+	uint8_t channel;
+} EVE_box_t;
+
+static void EVE_box_measure(const EVE_color_t *colors, EVE_box_t *box)
+{
+	uint32_t low[4] = {255, 255, 255, 255};
+	uint32_t high[4] = {0, 0, 0, 0};
+	uint32_t index, value;
+	uint8_t channel;
+
+	for(index = box->start; index < (box->start + box->count); index++)
+	{
+		for(channel = 0; channel < 4; channel++)
+		{
+			value = (colors[index].color >> (channel * 8)) & 0xFF;
+			low[channel] = (value < low[channel]) ? value : low[channel];
+			high[channel] = (value > high[channel]) ? value : high[channel];
+		}
+	}
+
+	box->range = 0;
+	box->channel = 0;
+
+	for(channel = 0; channel < 4; channel++)
+	{
+		if((high[channel] - low[channel]) > box->range)
+		{
+			box->range = high[channel] - low[channel];
+			box->channel = channel;
+		}
+	}
+}
+
+
+static int EVE_image_quantize(const EVE_image_t *image, uint8_t *indices, uint8_t *palette)
+{
+	EVE_color_t *colors;
+	EVE_color_t key;
+	EVE_color_t *found;
+	EVE_box_t boxes[256];
+	uint32_t pixels = image->width * image->height;
+	uint32_t unique = 0;
+	uint32_t count = 1;
+	uint32_t index, half, sum, split;
+	uint64_t total[4], weight;
+	uint8_t channel;
+	int best;
+
+	colors = malloc(pixels * sizeof(EVE_color_t));
+
+	if(colors == NULL)
+	{
+		return -1;
+	}
+
+	for(index = 0; index < pixels; index++)
+	{
+		memcpy(&colors[index].color, &image->pixels[index * 4], 4);
+		colors[index].count = 1;
+	}
+
+	qsort(colors, pixels, sizeof(EVE_color_t), EVE_color_compare);
+
+	for(index = 0; index < pixels; index++)
+	{
+		if((unique != 0) && (colors[unique - 1].color == colors[index].color))
+		{
+			colors[unique - 1].count++;
+		}
+		else
+		{
+			colors[unique++] = colors[index];
+		}
+	}
+
+	boxes[0].start = 0;
+	boxes[0].count = unique;
+	EVE_box_measure(colors, &boxes[0]);
+
+	while(count < 256)
+	{
+		best = -1;
+
+		for(index = 0; index < count; index++)
+		{
+			if((boxes[index].count > 1) && ((best < 0) || (boxes[index].range > boxes[best].range)))
+			{
+				best = (int) index;
+			}
+		}
+
+		if((best < 0) || (boxes[best].range == 0))
+		{
+			break;
+		}
+
+		qsort(&colors[boxes[best].start], boxes[best].count, sizeof(EVE_color_t), EVE_color_compare_channel[boxes[best].channel]);
+
+		/* split where half of the pixels in the box are on each side */
+		half = 0;
+
+		for(index = boxes[best].start; index < (boxes[best].start + boxes[best].count); index++)
+		{
+			half += colors[index].count;
+		}
+
+		half /= 2;
+		sum = 0;
+		split = 1;
+
+		for(index = boxes[best].start; index < (boxes[best].start + boxes[best].count - 1); index++)
+		{
+			sum += colors[index].count;
+
+			if(sum >= half)
+			{
+				split = index - boxes[best].start + 1;
+				break;
+			}
+		}
+
+		boxes[count].start = boxes[best].start + split;
+		boxes[count].count = boxes[best].count - split;
+		boxes[best].count = split;
+		EVE_box_measure(colors, &boxes[best]);
+		EVE_box_measure(colors, &boxes[count]);
+		count++;
+	}
+
+	memset(palette, 0, 1024);
+
+	for(best = 0; best < (int) count; best++)
+	{
+		memset(total, 0, sizeof(total));
+		weight = 0;
+
+		for(index = boxes[best].start; index < (boxes[best].start + boxes[best].count); index++)
+		{
+			for(channel = 0; channel < 4; channel++)
+			{
+				total[channel] += (uint64_t) ((colors[index].color >> (channel * 8)) & 0xFF) * colors[index].count;
+			}
+
+			weight += colors[index].count;
+			colors[index].index = (uint32_t) best;
+		}
+
+		/* ARGB8 little-endian: B, G, R, A */
+		palette[(best * 4) + 0] = (uint8_t) ((total[2] + (weight / 2)) / weight);
+		palette[(best * 4) + 1] = (uint8_t) ((total[1] + (weight / 2)) / weight);
+		palette[(best * 4) + 2] = (uint8_t) ((total[0] + (weight / 2)) / weight);
+		palette[(best * 4) + 3] = (uint8_t) ((total[3] + (weight / 2)) / weight);
+	}
+
+	qsort(colors, unique, sizeof(EVE_color_t), EVE_color_compare);
+
+	for(index = 0; index < pixels; index++)
+	{
+		memcpy(&key.color, &image->pixels[index * 4], 4);
+		found = bsearch(&key, colors, unique, sizeof(EVE_color_t), EVE_color_compare);
+		indices[index] = (uint8_t) found->index;
+	}
+
+	free(colors);
+	return 0;
+}
+
+
+/* convert the RGBA8888 image to the format, returns 0 on success */
+int EVE_image_convert(const EVE_image_t *image, uint8_t format, EVE_bitmap_data_t *bitmap)
+{
+	const uint8_t *pixel;
+	uint8_t *line;
+	uint32_t x, y, value;
+
+	memset(bitmap, 0, sizeof(EVE_bitmap_data_t));
+	bitmap->stride = EVE_image_stride(format, image->width);
+	bitmap->size = bitmap->stride * image->height;
+
+	if(bitmap->stride == 0)
+	{
+		return -1;
+	}
+
+	bitmap->data = calloc(1, bitmap->size);
+
+	if(bitmap->data == NULL)
+	{
+		return -1;
+	}
+
+	if((format == EVE_IMAGE_PALETTED) || (format == EVE_IMAGE_PALETTED8))
+	{
+		bitmap->palette_size = 1024;
+		bitmap->palette = malloc(bitmap->palette_size);
+
+		if((bitmap->palette == NULL) || (EVE_image_quantize(image, bitmap->data, bitmap->palette) != 0))
+		{
+			EVE_bitmap_data_free(bitmap);
+			return -1;
+		}
+
+		return 0;
+	}
+
+	for(y = 0; y < image->height; y++)
+	{
+		pixel = &image->pixels[y * image->width * 4];
+		line = &bitmap->data[y * bitmap->stride];
+
+		for(x = 0; x < image->width; x++)
+		{
+			switch(format)
+			{
+				case EVE_IMAGE_L1:
+					line[x / 8] |= (uint8_t) ((EVE_image_luminance(pixel) >= 128) ? (0x80 >> (x % 8)) : 0);
+					break;
+
+				case EVE_IMAGE_L2:
+					line[x / 4] |= (uint8_t) (EVE_image_scale(EVE_image_luminance(pixel), 3) << (6 - ((x % 4) * 2)));
+					break;
+
+				case EVE_IMAGE_L4:
+					line[x / 2] |= (uint8_t) (EVE_image_scale(EVE_image_luminance(pixel), 15) << ((x & 1) ? 0 : 4));
+					break;
+
+				case EVE_IMAGE_L8:
+					line[x] = (uint8_t) EVE_image_luminance(pixel);
+					break;
+
+				case EVE_IMAGE_RGB565:
+					value = (EVE_image_scale(pixel[0], 31) << 11) | (EVE_image_scale(pixel[1], 63) << 5) | EVE_image_scale(pixel[2], 31);
+					line[x * 2] = (uint8_t) value;
+					line[(x * 2) + 1] = (uint8_t) (value >> 8);
+					break;
+
+				case EVE_IMAGE_ARGB1555:
+					value = ((pixel[3] >= 128) ? 0x8000U : 0) | (EVE_image_scale(pixel[0], 31) << 10) | (EVE_image_scale(pixel[1], 31) << 5) | EVE_image_scale(pixel[2], 31);
+					line[x * 2] = (uint8_t) value;
+					line[(x * 2) + 1] = (uint8_t) (value >> 8);
+					break;
+
+				case EVE_IMAGE_ARGB4:
+					value = (EVE_image_scale(pixel[3], 15) << 12) | (EVE_image_scale(pixel[0], 15) << 8) | (EVE_image_scale(pixel[1], 15) << 4) | EVE_image_scale(pixel[2], 15);
+					line[x * 2] = (uint8_t) value;
+					line[(x * 2) + 1] = (uint8_t) (value >> 8);
+					break;
+
+				default:
+					break;
+			}
+
+			pixel += 4;
+		}
+	}
+
+	return 0;
+}
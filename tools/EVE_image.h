@@ -0,0 +1,57 @@
+/*
+@file    EVE_image.h
+@brief   loading images on the host and converting them to EVE bitmap formats
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+@section History
+
+4.1
+- first version
+
+*/
+
+#ifndef EVE_IMAGE_H_
+#define EVE_IMAGE_H_
+
+#include <stdint.h>
+
+/* the values are the same as for BITMAP_LAYOUT */
+#define EVE_IMAGE_ARGB1555	0
+#define EVE_IMAGE_L1		1
+#define EVE_IMAGE_L4		2
+#define EVE_IMAGE_L8		3
+#define EVE_IMAGE_ARGB4		6
+#define EVE_IMAGE_RGB565	7
+#define EVE_IMAGE_PALETTED	8
+#define EVE_IMAGE_PALETTED8	16
+#define EVE_IMAGE_L2		17
+#define EVE_IMAGE_RAW		0xFF	/* data that already is in the target format */
+
+typedef struct
+{
+	uint32_t width;
+	uint32_t height;
+	uint8_t *pixels;	/* RGBA8888, width * height * 4 bytes */
+} EVE_image_t;
+
+typedef struct
+{
+	uint8_t *data;		/* the bitmap as it goes into RAM_G */
+	uint32_t size;
+	uint32_t stride;
+	uint8_t *palette;	/* 256 entries ARGB8 for the paletted formats, NULL for all others */
+	uint32_t palette_size;
+} EVE_bitmap_data_t;
+
+int EVE_image_load(const char *path, EVE_image_t *image);
+int EVE_image_load_png(const char *path, EVE_image_t *image);
+int EVE_image_load_bmp(const char *path, EVE_image_t *image);
+void EVE_image_free(EVE_image_t *image);
+
+uint32_t EVE_image_stride(uint8_t format, uint32_t width);
+int EVE_image_convert(const EVE_image_t *image, uint8_t format, EVE_bitmap_data_t *bitmap);
+void EVE_bitmap_data_free(EVE_bitmap_data_t *bitmap);
+
+#endif /* EVE_IMAGE_H_ */
@@ -0,0 +1,604 @@
+/*
+@file    EVE_pack.c
+@brief   offline asset packer, converts images to EVE bitmap formats, deflates them and assigns addresses
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+eve_pack [options] name:FORMAT:file[:WIDTHxHEIGHT] ...
+
+-t chip     FT80x, FT81x or BT81x, default is FT81x
+-o name     base name of the generated files, default is "assets" for assets.c and assets.h
+-a address  first address in RAM_G, default is 0
+-f offset   put the assets into the external flash of a BT81x, starting at offset, 0 for the default of 8192,
+            the data is written to name.bin which needs to be programmed to the flash at that offset,
+            offsets below 8192 are rejected as the blob and the directory of EVE_flashfs.c are there
+-u          do not deflate the data, it is uploaded with EVE_memWrite_flash_buffer() then
+-j jobs     number of threads, default is the number of cores
+
+FORMAT is one of L1, L2, L4, L8, RGB565, ARGB1555, ARGB4, PALETTED or RAW.
+The file is read as PNG or as BMP when it ends with .bmp.
+When WIDTHxHEIGHT is given the file is taken as is, it already needs to be in FORMAT.
+RAW is for data that is not a bitmap, like a JPEG for EVE_cmd_loadimage(), it is never deflated.
+PALETTED is PALETTED with the palette in RAM_PAL on FT80x and PALETTED8 with the palette in RAM_G for FT81x and BT81x.
+
+eve_pack -t FT81x -o tft_assets logo:L8:logo.png pic:RGB565:pic.png
+
+generates tft_assets.h with the addresses, formats and sizes:
+
+#define MEM_LOGO	0x00000000UL
+#define LOGO_FORMAT	EVE_L8
+#define LOGO_WIDTH	38
+#define LOGO_HEIGHT	59
+#define LOGO_STRIDE	38
+#define LOGO_SIZE	2242UL
+#define LOGO_LENGTH	406UL
+...
+
+and tft_assets.c with the arrays that are uploaded with:
+EVE_cmd_inflate(MEM_LOGO, logo, LOGO_LENGTH);
+
+The images are loaded, converted and deflated by a pool of threads, the addresses are assigned afterwards
+in the order the assets are given on the command line, so the output does not depend on the number of threads.
+
+@section History
+
+4.1
+- first version
+- the data is deflated with EVE_deflate()
+- the flash offset defaults to 8192 as the sector at EVE_RAM_FLASH_POSTBLOB holds the directory of EVE_flashfs.c,
+  lower offsets are rejected
+- the formats, the asset parser and reading files are in EVE_asset.c
+
+*/
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "EVE_asset.h"
+#include "EVE_deflate.h"
+#include "EVE_image.h"
+
+
+#define EVE_PACK_ALIGN		4UL		/* bitmaps in RAM_G */
+#define EVE_PACK_FLASH_ALIGN	64UL	/* CMD_FLASHREAD needs the source to be 64-byte aligned */
+#define EVE_PACK_FLASH_DATA	8192UL	/* EVE_FLASHFS_DATA, the blob and the directory of EVE_flashfs.c come first */
+
+typedef struct
+{
+	const char *name;
+	uint32_t ram_size;
+	uint8_t paletted;
+	uint8_t l2;
+	uint8_t flash;
+} EVE_chip_t;
+
+static const EVE_chip_t chips[] =
+{
+	{"FT80x", 256UL * 1024UL, EVE_IMAGE_PALETTED, 0, 0},
+	{"FT81x", 1024UL * 1024UL, EVE_IMAGE_PALETTED8, 0, 0},
+	{"BT81x", 1024UL * 1024UL, EVE_IMAGE_PALETTED8, 1, 1},
+};
+
+typedef struct
+{
+	char name[64];
+	char path[512];
+	uint8_t format;
+	uint8_t as_is;		/* the file already is in the target format */
+	uint32_t width;
+	uint32_t height;
+	EVE_bitmap_data_t bitmap;
+	uint8_t *packed;	/* what goes into the C array */
+	uint32_t packed_size;
+	uint8_t *packed_palette;
+	uint32_t packed_palette_size;
+	uint32_t address;
+	uint32_t palette_address;
+	int error;
+} EVE_asset_t;
+
+static EVE_asset_t *assets;
+static int assets_count;
+static int assets_next;
+static pthread_mutex_t assets_lock = PTHREAD_MUTEX_INITIALIZER;
+static const EVE_chip_t *chip = &chips[1];
+static int deflate_data = 1;
+static int flash_mode = 0;
+
+
+/* name:FORMAT:file[:WIDTHxHEIGHT] */
+static int EVE_pack_parse(const char *spec, EVE_asset_t *asset)
+{
+	EVE_asset_spec_t parsed;
+
+	if(EVE_asset_parse(spec, chip->paletted, chip->l2, &parsed) != 0)
+	{
+		return -1;
+	}
+
+	memset(asset, 0, sizeof(EVE_asset_t));
+	strcpy(asset->name, parsed.name);
+	strcpy(asset->path, parsed.path);
+	asset->format = parsed.format;
+	asset->as_is = parsed.as_is;
+	asset->width = parsed.width;
+	asset->height = parsed.height;
+
+	if(asset->format == EVE_IMAGE_RAW)
+	{
+		asset->as_is = 1;
+	}
+
+	return 0;
+}
+
+
+static int EVE_pack_asset(EVE_asset_t *asset)
+{
+	EVE_image_t image;
+
+	if(asset->as_is)
+	{
+		asset->bitmap.data = EVE_asset_read(asset->path, &asset->bitmap.size);
+
+		if(asset->bitmap.data == NULL)
+		{
+			return -1;
+		}
+
+		asset->bitmap.stride = EVE_image_stride(asset->format, asset->width);
+	}
+	else
+	{
+		if(EVE_image_load(asset->path, &image) != 0)
+		{
+			return -1;
+		}
+
+		asset->width = image.width;
+		asset->height = image.height;
+
+		if(EVE_image_convert(&image, asset->format, &asset->bitmap) != 0)
+		{
+			fprintf(stderr, "%s: conversion failed\n", asset->name);
+			EVE_image_free(&image);
+			return -1;
+		}
+
+		EVE_image_free(&image);
+	}
+
+	/* flash is read with CMD_FLASHREAD, RAW data is for EVE_cmd_loadimage() */
+	if((deflate_data == 0) || flash_mode || (asset->format == EVE_IMAGE_RAW))
+	{
+		asset->packed = asset->bitmap.data;
+		asset->packed_size = asset->bitmap.size;
+		asset->packed_palette = asset->bitmap.palette;
+		asset->packed_palette_size = asset->bitmap.palette_size;
+		return 0;
+	}
+
+	asset->packed = EVE_deflate(asset->bitmap.data, asset->bitmap.size, &asset->packed_size, 0, 1);
+
+	if(asset->bitmap.palette != NULL)
+	{
+		asset->packed_palette = EVE_deflate(asset->bitmap.palette, asset->bitmap.palette_size, &asset->packed_palette_size, 0, 1);
+	}
+
+	if((asset->packed == NULL) || ((asset->bitmap.palette != NULL) && (asset->packed_palette == NULL)))
+	{
+		fprintf(stderr, "%s: deflate failed\n", asset->name);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static void *EVE_pack_worker(void *unused)
+{
+	int index;
+
+	(void) unused;
+
+	for(;;)
+	{
+		pthread_mutex_lock(&assets_lock);
+		index = assets_next++;
+		pthread_mutex_unlock(&assets_lock);
+
+		if(index >= assets_count)
+		{
+			return NULL;
+		}
+
+		assets[index].error = EVE_pack_asset(&assets[index]);
+	}
+}
+
+
+static void EVE_pack_upper(const char *name, char *upper)
+{
+	while(*name != 0)
+	{
+		*upper++ = (char) toupper((unsigned char) *name++);
+	}
+
+	*upper = 0;
+}
+
+
+static void EVE_pack_array(FILE *file, const char *name, const uint8_t *data, uint32_t size)
+{
+	uint32_t index;
+
+	fprintf(file, "const uint8_t %s[%u] PROGMEM =\n{\n", name, size);
+
+	for(index = 0; index < size; index++)
+	{
+		fprintf(file, "%s0x%02X,%s", ((index % 16) == 0) ? "\t" : "", data[index], (((index % 16) == 15) || (index == (size - 1))) ? "\n" : " ");
+	}
+
+	fprintf(file, "};\n\n");
+}
+
+
+static int EVE_pack_write(const char *base, uint32_t start, uint32_t end)
+{
+	char path[600];
+	char upper[64];
+	char guard[128];
+	const EVE_asset_format_t *format;
+	EVE_asset_t *asset;
+	FILE *source = NULL;
+	FILE *header;
+	FILE *image = NULL;
+	uint8_t fill[EVE_PACK_FLASH_ALIGN];
+	uint32_t position;
+	int index;
+
+	snprintf(path, sizeof(path), "%s.h", base);
+	header = fopen(path, "w");
+
+	if(flash_mode)
+	{
+		snprintf(path, sizeof(path), "%s.bin", base);
+		image = fopen(path, "wb");
+	}
+	else
+	{
+		snprintf(path, sizeof(path), "%s.c", base);
+		source = fopen(path, "w");
+	}
+
+	if((header == NULL) || ((source == NULL) && (image == NULL)))
+	{
+		perror(path);
+		return -1;
+	}
+
+	EVE_pack_upper(strrchr(base, '/') ? (strrchr(base, '/') + 1) : base, guard);
+
+	for(index = 0; guard[index] != 0; index++)
+	{
+		guard[index] = isalnum((unsigned char) guard[index]) ? guard[index] : '_';
+	}
+
+	fprintf(header, "/* generated by eve_pack for %s, do not edit */\n\n", chip->name);
+	fprintf(header, "#ifndef %s_H_\n#define %s_H_\n\n", guard, guard);
+
+	if(source != NULL)
+	{
+		fprintf(header, "#if defined (__AVR__)\n\t#include <avr/pgmspace.h>\n#else\n\t#define PROGMEM\n#endif\n\n");
+		fprintf(source, "/* generated by eve_pack for %s, do not edit */\n\n", chip->name);
+		fprintf(source, "#include <stdint.h>\n\n#if defined (__AVR__)\n\t#include <avr/pgmspace.h>\n#else\n\t#define PROGMEM\n#endif\n\n");
+	}
+
+	memset(fill, 0xFF, sizeof(fill));
+	position = start;
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+		format = EVE_asset_format(asset->format);
+		EVE_pack_upper(asset->name, upper);
+
+		fprintf(header, "/* %s", asset->path);
+
+		if(format->define != NULL)
+		{
+			fprintf(header, ", %ux%u %s", asset->width, asset->height, format->name);
+		}
+
+		fprintf(header, ", %u bytes */\n", asset->bitmap.size);
+		fprintf(header, "#define %s_%s\t0x%08XUL\n", flash_mode ? "FLASH" : "MEM", upper, asset->address);
+
+		if(format->define != NULL)
+		{
+			fprintf(header, "#define %s_FORMAT\t%s\n", upper, format->define);
+			fprintf(header, "#define %s_WIDTH\t%u\n", upper, asset->width);
+			fprintf(header, "#define %s_HEIGHT\t%u\n", upper, asset->height);
+			fprintf(header, "#define %s_STRIDE\t%u\n", upper, asset->bitmap.stride);
+		}
+
+		fprintf(header, "#define %s_SIZE\t%uUL\n", upper, asset->bitmap.size);
+
+		if(asset->bitmap.palette != NULL)
+		{
+			if(asset->format == EVE_IMAGE_PALETTED)
+			{
+				fprintf(header, "#define MEM_PAL_%s\tEVE_RAM_PAL\n", upper);
+			}
+			else
+			{
+				fprintf(header, "#define %s_PAL_%s\t0x%08XUL\n", flash_mode ? "FLASH" : "MEM", upper, asset->palette_address);
+			}
+		}
+
+		if(source != NULL)
+		{
+			fprintf(header, "#define %s_LENGTH\t%uUL\n", upper, asset->packed_size);
+			fprintf(header, "extern const uint8_t %s[%u] PROGMEM;\n", asset->name, asset->packed_size);
+			EVE_pack_array(source, asset->name, asset->packed, asset->packed_size);
+
+			if(asset->packed_palette != NULL)
+			{
+				snprintf(path, sizeof(path), "%s_pal", asset->name);
+				fprintf(header, "#define %s_PAL_LENGTH\t%uUL\n", upper, asset->packed_palette_size);
+				fprintf(header, "extern const uint8_t %s_pal[%u] PROGMEM;\n", asset->name, asset->packed_palette_size);
+				EVE_pack_array(source, path, asset->packed_palette, asset->packed_palette_size);
+			}
+		}
+		else
+		{
+			/* assets in flash are placed one after the other, the gaps are filled with 0xff */
+			fwrite(fill, 1, asset->address - position, image);
+			fwrite(asset->packed, 1, asset->packed_size, image);
+			position = asset->address + asset->packed_size;
+
+			if(asset->packed_palette != NULL)
+			{
+				fwrite(fill, 1, asset->palette_address - position, image);
+				fwrite(asset->packed_palette, 1, asset->packed_palette_size, image);
+				position = asset->palette_address + asset->packed_palette_size;
+			}
+		}
+
+		fprintf(header, "\n");
+	}
+
+	fprintf(header, "#define %s_%s_END\t0x%08XUL\n\n", flash_mode ? "FLASH" : "MEM", guard, end);
+	fprintf(header, "#endif /* %s_H_ */\n", guard);
+
+	fclose(header);
+
+	if(source != NULL)
+	{
+		fclose(source);
+	}
+
+	if(image != NULL)
+	{
+		fclose(image);
+	}
+
+	return 0;
+}
+
+
+static uint32_t EVE_pack_align(uint32_t address, uint32_t align)
+{
+	return (address + align - 1) & ~(align - 1);
+}
+
+
+static void EVE_pack_usage(void)
+{
+	fprintf(stderr, "usage: eve_pack [-t FT80x|FT81x|BT81x] [-o name] [-a address] [-f offset] [-u] [-j jobs] name:FORMAT:file[:WIDTHxHEIGHT] ...\n");
+	fprintf(stderr, "FORMAT is one of L1, L2, L4, L8, RGB565, ARGB1555, ARGB4, PALETTED or RAW\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char *base = "assets";
+	pthread_t *threads;
+	uint32_t start = 0;
+	uint32_t address, limit, align, total_size = 0, total_packed = 0;
+	long jobs;
+	int option, index, started;
+	size_t entry;
+
+	jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+	while((option = getopt(argc, argv, "t:o:a:f:uj:h")) != -1)
+	{
+		switch(option)
+		{
+			case 't':
+				chip = NULL;
+
+				for(entry = 0; entry < (sizeof(chips) / sizeof(chips[0])); entry++)
+				{
+					if(strcasecmp(optarg, chips[entry].name) == 0)
+					{
+						chip = &chips[entry];
+					}
+				}
+
+				if(chip == NULL)
+				{
+					EVE_pack_usage();
+					return 1;
+				}
+				break;
+
+			case 'o':
+				base = optarg;
+				break;
+
+			case 'a':
+				start = (uint32_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'f':
+				flash_mode = 1;
+				start = (uint32_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'u':
+				deflate_data = 0;
+				break;
+
+			case 'j':
+				jobs = strtol(optarg, NULL, 0);
+				break;
+
+			default:
+				EVE_pack_usage();
+				return 1;
+		}
+	}
+
+	if(flash_mode && (chip->flash == 0))
+	{
+		fprintf(stderr, "flash needs a BT81x\n");
+		return 1;
+	}
+
+	if(flash_mode && (start == 0))
+	{
+		start = EVE_PACK_FLASH_DATA;
+	}
+
+	if(flash_mode && (start < EVE_PACK_FLASH_DATA))
+	{
+		fprintf(stderr, "flash offset 0x%X overlaps the blob or the directory of EVE_flashfs.c, it needs to be at least 0x%lX\n",
+			start, EVE_PACK_FLASH_DATA);
+		return 1;
+	}
+
+	assets_count = argc - optind;
+
+	if(assets_count <= 0)
+	{
+		EVE_pack_usage();
+		return 1;
+	}
+
+	assets = calloc((size_t) assets_count, sizeof(EVE_asset_t));
+
+	if(assets == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	for(index = 0; index < assets_count; index++)
+	{
+		if(EVE_pack_parse(argv[optind + index], &assets[index]) != 0)
+		{
+			fprintf(stderr, "%s: expected name:FORMAT:file[:WIDTHxHEIGHT]\n", argv[optind + index]);
+			return 1;
+		}
+	}
+
+	if(jobs < 1)
+	{
+		jobs = 1;
+	}
+
+	if(jobs > assets_count)
+	{
+		jobs = assets_count;
+	}
+
+	threads = malloc((size_t) jobs * sizeof(pthread_t));
+	started = 0;
+
+	if(threads != NULL)
+	{
+		/* the workers take the assets from a shared index, fewer threads only take longer */
+		for(index = 0; index < jobs; index++)
+		{
+			if(pthread_create(&threads[started], NULL, EVE_pack_worker, NULL) == 0)
+			{
+				started++;
+			}
+		}
+	}
+
+	if(started == 0)
+	{
+		EVE_pack_worker(NULL);
+	}
+
+	for(index = 0; index < started; index++)
+	{
+		pthread_join(threads[index], NULL);
+	}
+
+	free(threads);
+
+	/* the addresses are assigned in the order of the command line */
+	if(flash_mode)
+	{
+		align = EVE_PACK_FLASH_ALIGN;
+		limit = 0xFFFFFFFFUL;
+	}
+	else
+	{
+		align = EVE_PACK_ALIGN;
+		limit = chip->ram_size;
+	}
+
+	start = EVE_pack_align(start, align);
+	address = start;
+
+	printf("%-16s %-10s %-10s %-9s %10s %10s %6s\n", "name", flash_mode ? "flash" : "RAM_G", "format", "size", "bytes", "packed", "ratio");
+
+	for(index = 0; index < assets_count; index++)
+	{
+		EVE_asset_t *asset = &assets[index];
+
+		if(asset->error != 0)
+		{
+			return 1;
+		}
+
+		asset->address = EVE_pack_align(address, align);
+		address = asset->address + asset->bitmap.size;
+
+		if(asset->bitmap.palette != NULL)
+		{
+			/* PALETTED on FT80x uses RAM_PAL, the palette is not in RAM_G then */
+			if(asset->format == EVE_IMAGE_PALETTED8)
+			{
+				asset->palette_address = EVE_pack_align(address, align);
+				address = asset->palette_address + asset->bitmap.palette_size;
+			}
+		}
+
+		total_size += asset->bitmap.size + asset->bitmap.palette_size;
+		total_packed += asset->packed_size + asset->packed_palette_size;
+
+		printf("%-16s 0x%08X %-10s %4ux%-4u %10u %10u %5.1f%%\n", asset->name, asset->address, EVE_asset_format(asset->format)->name,
+			asset->width, asset->height, asset->bitmap.size + asset->bitmap.palette_size, asset->packed_size + asset->packed_palette_size,
+			(asset->bitmap.size != 0) ? (100.0 * (asset->packed_size + asset->packed_palette_size) / (asset->bitmap.size + asset->bitmap.palette_size)) : 0.0);
+	}
+
+	printf("%u bytes from 0x%08X to 0x%08X, %u bytes to transfer\n", total_size, start, address, total_packed);
+
+	if(address > limit)
+	{
+		fprintf(stderr, "the assets need 0x%08X bytes, the %s only has 0x%08X bytes of RAM_G\n", address, chip->name, limit);
+		return 1;
+	}
+
+	return (EVE_pack_write(base, start, address) == 0) ? 0 : 1;
+}
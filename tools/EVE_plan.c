@@ -0,0 +1,866 @@
+/*
+@file    EVE_plan.c
+@brief   upload planner, picks raw, inflate, loadimage or a flash source for each asset and orders the uploads
+@version 4.1
+@date    2026-10-19
+@author  Rudolph Riedel
+
+eve_plan [options] name:FORMAT:file[:WIDTHxHEIGHT] ...
+
+-t chip     FT80x, FT81x or BT81x, default is FT81x
+-s hz       SPI clock, default is 20000000
+-l lanes    1 for SPI, 2 or 4 for dual or quad SPI, default is 1
+-r bytes    measured bytes per second the host gets to RAM_G, replaces -s and -l
+-i bytes    bytes per second CMD_INFLATE writes to RAM_G, default is 12000000
+-J pixels   pixels per second CMD_LOADIMAGE decodes from a JPEG, default is 4000000
+-P pixels   pixels per second CMD_LOADIMAGE decodes from a PNG, default is 1500000
+-f          the assets can be put into the external flash of a BT81x as well
+-F bytes    bytes per second read from the flash, default is 40000000
+-w us       time the co-processor needs for a command besides the data, default is 30
+-o file     write the plan as CSV to the file
+-j jobs     number of threads for deflating, default is the number of cores
+
+FORMAT and WIDTHxHEIGHT are the same as for eve_pack.
+A JPEG is only decoded by CMD_LOADIMAGE, FORMAT needs to be RGB565 or L8 for it, RAW picks one from the JPEG.
+A PNG is converted like eve_pack does for the raw and inflate transfers, CMD_LOADIMAGE is an option as well
+when it decodes the PNG to FORMAT, RAW picks the format the PNG decodes to.
+
+The figures for the co-processor differ with the chip and the clock, they are meant to be measured on the target,
+with REG_CLOCK before and after CMD_INFLATE of a known stream for example.
+
+Every method has a time on the bus and a time the co-processor is busy:
+raw is a memory write that only needs the bus,
+inflate and loadimage stream the data thru the command FIFO and need both at the same time,
+flash sources only need the co-processor.
+A memory write does not go thru the co-processor, so the raw writes run while the co-processor reads the flash.
+The uploads are ordered like that, the commands for the flash first, the raw writes while these run and the transfers
+thru the command FIFO last, the shortest first in each group.
+The boot time of that order is minimized by starting with the fastest method for each asset and then changing
+single assets to another method as long as that makes the total shorter.
+
+eve_plan -t BT81x -s 30000000 -l 4 -f -o plan.csv logo:L8:logo.png photo:RGB565:photo.jpg font:RAW:font.bin
+
+The CSV has the steps in the order they are issued, with the bytes for the bus and the flash and the times
+these are expected to start and end.
+
+@section History
+
+4.1
+- first version
+- the formats, the asset parser and reading files are in EVE_asset.c, names are checked like eve_pack does
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#include "EVE_asset.h"
+#include "EVE_deflate.h"
+#include "EVE_image.h"
+
+
+#define EVE_PLAN_INFLATE	12000000UL	/* rough figures, measure them on the target */
+#define EVE_PLAN_JPEG		4000000UL
+#define EVE_PLAN_PNG		1500000UL
+#define EVE_PLAN_FLASH		40000000UL
+#define EVE_PLAN_COMMAND	30UL
+
+enum
+{
+	EVE_PLAN_RAW = 0,
+	EVE_PLAN_DEFLATE,
+	EVE_PLAN_LOADIMAGE,
+	EVE_PLAN_FLASHREAD,
+	EVE_PLAN_FLASH_INFLATE,
+	EVE_PLAN_FLASH_LOADIMAGE,
+	EVE_PLAN_METHODS
+};
+
+static const char *const methods[EVE_PLAN_METHODS] =
+{
+	"raw", "inflate", "loadimage", "flash", "flash-inflate", "flash-loadimage"
+};
+
+/* the data of a raw write only goes over the bus, flash sources only keep the co-processor busy */
+#define EVE_PLAN_BUS_ONLY(method)	((method) == EVE_PLAN_RAW)
+#define EVE_PLAN_CHIP_ONLY(method)	((method) >= EVE_PLAN_FLASHREAD)
+
+typedef struct
+{
+	const char *name;
+	uint8_t paletted;
+	uint8_t png;	/* CMD_LOADIMAGE decodes PNG as well */
+	uint8_t l2;
+	uint8_t flash;
+} EVE_chip_t;
+
+static const EVE_chip_t chips[] =
+{
+	{"FT80x", EVE_IMAGE_PALETTED, 0, 0, 0},
+	{"FT81x", EVE_IMAGE_PALETTED8, 1, 0, 0},
+	{"BT81x", EVE_IMAGE_PALETTED8, 1, 1, 1},
+};
+
+typedef struct
+{
+	double bus;			/* bytes per second from the host to RAM_G */
+	double inflate;		/* bytes per second */
+	double jpeg;		/* pixels per second */
+	double png;
+	double flash;		/* bytes per second */
+	double command;		/* seconds */
+} EVE_link_t;
+
+enum
+{
+	EVE_PLAN_FILE = 0,
+	EVE_PLAN_FILE_JPEG,
+	EVE_PLAN_FILE_PNG
+};
+
+typedef struct
+{
+	char name[64];
+	char path[512];
+	uint8_t format;
+	uint8_t as_is;
+	uint8_t type;			/* what the file is */
+	uint32_t width;
+	uint32_t height;
+	uint32_t size;			/* bytes in RAM_G, with the palette */
+	uint32_t packed;		/* deflated, 0 when it can not be inflated */
+	uint32_t file;			/* bytes of the file for CMD_LOADIMAGE, 0 when it can not be decoded */
+	uint8_t usable[EVE_PLAN_METHODS];
+	double bus[EVE_PLAN_METHODS];	/* seconds */
+	double chip[EVE_PLAN_METHODS];
+	uint8_t method;
+	double start;
+	double end;
+} EVE_asset_t;
+
+static EVE_asset_t *assets;
+static int assets_count;
+static const EVE_chip_t *chip = &chips[1];
+
+
+/* name:FORMAT:file[:WIDTHxHEIGHT] */
+static int EVE_plan_parse(const char *spec, EVE_asset_t *asset)
+{
+	EVE_asset_spec_t parsed;
+
+	if(EVE_asset_parse(spec, chip->paletted, chip->l2, &parsed) != 0)
+	{
+		return -1;
+	}
+
+	memset(asset, 0, sizeof(EVE_asset_t));
+	strcpy(asset->name, parsed.name);
+	strcpy(asset->path, parsed.path);
+	asset->format = parsed.format;
+	asset->as_is = parsed.as_is;
+	asset->width = parsed.width;
+	asset->height = parsed.height;
+
+	return 0;
+}
+
+
+/* the size of a baseline JPEG from its SOF0 marker, CMD_LOADIMAGE does not decode progressive ones */
+static int EVE_plan_jpeg(const uint8_t *data, uint32_t size, EVE_asset_t *asset)
+{
+	uint32_t position = 2;
+	uint32_t length;
+	uint8_t marker;
+
+	while((position + 4) <= size)
+	{
+		if(data[position] != 0xFF)
+		{
+			break;
+		}
+
+		marker = data[position + 1];
+		length = ((uint32_t) data[position + 2] << 8) | data[position + 3];
+
+		if(marker == 0xC0)
+		{
+			if((position + 10) > size)
+			{
+				break;
+			}
+
+			asset->height = ((uint32_t) data[position + 5] << 8) | data[position + 6];
+			asset->width = ((uint32_t) data[position + 7] << 8) | data[position + 8];
+
+			if(asset->format == EVE_IMAGE_RAW)
+			{
+				asset->format = (data[position + 9] == 1) ? EVE_IMAGE_L8 : EVE_IMAGE_RGB565;
+			}
+
+			if((asset->format != EVE_IMAGE_L8) && (asset->format != EVE_IMAGE_RGB565))
+			{
+				fprintf(stderr, "%s: CMD_LOADIMAGE decodes a JPEG to RGB565 or L8\n", asset->name);
+				return -1;
+			}
+
+			return 0;
+		}
+
+		if((marker >= 0xC1) && (marker <= 0xCF) && (marker != 0xC4) && (marker != 0xC8) && (marker != 0xCC))
+		{
+			fprintf(stderr, "%s: only baseline JPEGs can be decoded by CMD_LOADIMAGE\n", asset->name);
+			return -1;
+		}
+
+		position += length + 2;
+	}
+
+	fprintf(stderr, "%s: no frame header in the JPEG\n", asset->name);
+	return -1;
+}
+
+
+/* the format CMD_LOADIMAGE decodes a PNG to, EVE_IMAGE_RAW when it can not decode it */
+static uint8_t EVE_plan_png(const uint8_t *data, uint32_t size)
+{
+	if((chip->png == 0) || (size < 29) || (data[24] != 8) || (data[28] != 0)) /* 8 bits per channel, not interlaced */
+	{
+		return EVE_IMAGE_RAW;
+	}
+
+	switch(data[25])
+	{
+		case 0:
+			return EVE_IMAGE_L8;
+		case 2:
+			return EVE_IMAGE_RGB565;
+		case 4:
+		case 6:
+			return EVE_IMAGE_ARGB4;
+		default:
+			return EVE_IMAGE_RAW; /* PALETTED565 and PALETTED4444 are not supported here */
+	}
+}
+
+
+/* converts and deflates the asset to get the sizes of the transfers */
+static int EVE_plan_measure(EVE_asset_t *asset, unsigned jobs)
+{
+	static const uint8_t png_signature[8] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+	EVE_bitmap_data_t bitmap;
+	EVE_image_t image;
+	uint8_t *data, *packed;
+	uint32_t size, packed_size;
+	uint8_t decoded = EVE_IMAGE_RAW;
+	int result = 0;
+
+	data = EVE_asset_read(asset->path, &size);
+
+	if(data == NULL)
+	{
+		return -1;
+	}
+
+	memset(&bitmap, 0, sizeof(bitmap));
+
+	if((asset->as_is == 0) && (size >= 3) && (data[0] == 0xFF) && (data[1] == 0xD8) && (data[2] == 0xFF))
+	{
+		asset->type = EVE_PLAN_FILE_JPEG;
+		result = EVE_plan_jpeg(data, size, asset);
+		asset->size = asset->width * asset->height * EVE_asset_format(asset->format)->bytes;
+		asset->file = size;
+		free(data);
+		return result;
+	}
+
+	if((asset->as_is == 0) && (size >= 8) && (memcmp(data, png_signature, 8) == 0))
+	{
+		asset->type = EVE_PLAN_FILE_PNG;
+		decoded = EVE_plan_png(data, size);
+
+		if(asset->format == EVE_IMAGE_RAW)
+		{
+			if(decoded == EVE_IMAGE_RAW)
+			{
+				fprintf(stderr, "%s: CMD_LOADIMAGE can not decode this PNG, give a FORMAT\n", asset->name);
+				free(data);
+				return -1;
+			}
+
+			asset->format = decoded;
+		}
+
+		if(decoded == asset->format)
+		{
+			asset->file = size;
+		}
+	}
+
+	if((asset->as_is != 0) || ((asset->format == EVE_IMAGE_RAW) && (asset->type == EVE_PLAN_FILE)))
+	{
+		bitmap.data = data;
+		bitmap.size = size;
+		asset->as_is = 1;
+	}
+	else
+	{
+		free(data);
+
+		if(EVE_image_load(asset->path, &image) != 0)
+		{
+			return -1;
+		}
+
+		asset->width = image.width;
+		asset->height = image.height;
+		result = EVE_image_convert(&image, asset->format, &bitmap);
+		EVE_image_free(&image);
+
+		if(result != 0)
+		{
+			fprintf(stderr, "%s: conversion failed\n", asset->name);
+			return -1;
+		}
+	}
+
+	asset->size = bitmap.size + bitmap.palette_size;
+	packed = EVE_deflate(bitmap.data, bitmap.size, &packed_size, 0, jobs);
+
+	if(packed == NULL)
+	{
+		result = -1;
+	}
+	else
+	{
+		asset->packed = packed_size;
+		free(packed);
+	}
+
+	if((result == 0) && (bitmap.palette != NULL))
+	{
+		packed = EVE_deflate(bitmap.palette, bitmap.palette_size, &packed_size, 0, jobs);
+
+		if(packed == NULL)
+		{
+			result = -1;
+		}
+		else
+		{
+			asset->packed += packed_size;
+			free(packed);
+		}
+	}
+
+	if(result != 0)
+	{
+		fprintf(stderr, "%s: deflate failed\n", asset->name);
+	}
+
+	EVE_bitmap_data_free(&bitmap);
+	return result;
+}
+
+
+static double EVE_plan_max(double a, double b)
+{
+	return (a > b) ? a : b;
+}
+
+
+/* the time on the bus and on the co-processor for every method that works for the asset */
+static void EVE_plan_costs(EVE_asset_t *asset, const EVE_link_t *link, uint8_t flash)
+{
+	double decode = (asset->type == EVE_PLAN_FILE_JPEG) ? link->jpeg : link->png;
+	double pixels = (double) asset->width * asset->height;
+	double padded = (double) ((asset->packed + 3UL) & ~3UL); /* the FIFO takes whole words */
+	double file = (double) ((asset->file + 3UL) & ~3UL);
+
+	memset(asset->usable, 0, sizeof(asset->usable));
+
+	if(asset->type != EVE_PLAN_FILE_JPEG)
+	{
+		asset->usable[EVE_PLAN_RAW] = 1;
+		asset->bus[EVE_PLAN_RAW] = asset->size / link->bus;
+		asset->chip[EVE_PLAN_RAW] = 0.0;
+
+		asset->usable[EVE_PLAN_DEFLATE] = 1;
+		asset->bus[EVE_PLAN_DEFLATE] = padded / link->bus;
+		asset->chip[EVE_PLAN_DEFLATE] = (asset->size / link->inflate) + link->command;
+
+		asset->usable[EVE_PLAN_FLASHREAD] = flash;
+		asset->bus[EVE_PLAN_FLASHREAD] = 0.0;
+		asset->chip[EVE_PLAN_FLASHREAD] = (asset->size / link->flash) + link->command;
+
+		asset->usable[EVE_PLAN_FLASH_INFLATE] = flash;
+		asset->bus[EVE_PLAN_FLASH_INFLATE] = 0.0;
+		asset->chip[EVE_PLAN_FLASH_INFLATE] = EVE_plan_max(asset->packed / link->flash, asset->size / link->inflate) + link->command;
+	}
+
+	if(asset->file != 0)
+	{
+		asset->usable[EVE_PLAN_LOADIMAGE] = 1;
+		asset->bus[EVE_PLAN_LOADIMAGE] = file / link->bus;
+		asset->chip[EVE_PLAN_LOADIMAGE] = (pixels / decode) + link->command;
+
+		asset->usable[EVE_PLAN_FLASH_LOADIMAGE] = flash;
+		asset->bus[EVE_PLAN_FLASH_LOADIMAGE] = 0.0;
+		asset->chip[EVE_PLAN_FLASH_LOADIMAGE] = EVE_plan_max(asset->file / link->flash, pixels / decode) + link->command;
+	}
+}
+
+
+/* the raw writes run while the co-processor works on the flash sources, the transfers thru the FIFO follow */
+static double EVE_plan_total(void)
+{
+	double bus = 0.0, chip_time = 0.0, fifo = 0.0;
+	EVE_asset_t *asset;
+	int index;
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+
+		if(EVE_PLAN_BUS_ONLY(asset->method))
+		{
+			bus += asset->bus[asset->method];
+		}
+		else if(EVE_PLAN_CHIP_ONLY(asset->method))
+		{
+			chip_time += asset->chip[asset->method];
+		}
+		else
+		{
+			fifo += EVE_plan_max(asset->bus[asset->method], asset->chip[asset->method]);
+		}
+	}
+
+	return EVE_plan_max(bus, chip_time) + fifo;
+}
+
+
+/* the method if it works for the asset, the one that is the fastest on its own otherwise */
+static uint8_t EVE_plan_fastest(const EVE_asset_t *asset, uint8_t method)
+{
+	uint8_t best = EVE_PLAN_METHODS;
+	uint8_t index;
+
+	if((method < EVE_PLAN_METHODS) && asset->usable[method])
+	{
+		return method;
+	}
+
+	for(index = 0; index < EVE_PLAN_METHODS; index++)
+	{
+		if(asset->usable[index] && ((best == EVE_PLAN_METHODS) ||
+			(EVE_plan_max(asset->bus[index], asset->chip[index]) < EVE_plan_max(asset->bus[best], asset->chip[best]))))
+		{
+			best = index;
+		}
+	}
+
+	return best;
+}
+
+
+/* the total when every asset that can uses the method */
+static double EVE_plan_all(uint8_t method)
+{
+	uint8_t kept[assets_count];
+	double total;
+	int index;
+
+	for(index = 0; index < assets_count; index++)
+	{
+		kept[index] = assets[index].method;
+		assets[index].method = EVE_plan_fastest(&assets[index], method);
+	}
+
+	total = EVE_plan_total();
+
+	for(index = 0; index < assets_count; index++)
+	{
+		assets[index].method = kept[index];
+	}
+
+	return total;
+}
+
+
+/* starts with the fastest method for each asset and changes single assets as long as the total gets shorter */
+static double EVE_plan_optimize(void)
+{
+	double total, trial;
+	uint8_t method, kept, improved;
+	int index;
+
+	for(index = 0; index < assets_count; index++)
+	{
+		assets[index].method = EVE_plan_fastest(&assets[index], EVE_PLAN_METHODS);
+	}
+
+	total = EVE_plan_total();
+
+	do
+	{
+		improved = 0;
+
+		for(index = 0; index < assets_count; index++)
+		{
+			kept = assets[index].method;
+
+			for(method = 0; method < EVE_PLAN_METHODS; method++)
+			{
+				if((assets[index].usable[method] == 0) || (method == kept))
+				{
+					continue;
+				}
+
+				assets[index].method = method;
+				trial = EVE_plan_total();
+
+				if(trial < (total - 1e-9))
+				{
+					total = trial;
+					kept = method;
+					improved = 1;
+				}
+			}
+
+			assets[index].method = kept;
+		}
+	} while(improved);
+
+	return total;
+}
+
+
+/* 0 for the flash sources, 1 for the raw writes, 2 for the transfers thru the FIFO */
+static int EVE_plan_group(const EVE_asset_t *asset)
+{
+	if(EVE_PLAN_CHIP_ONLY(asset->method))
+	{
+		return 0;
+	}
+
+	return EVE_PLAN_BUS_ONLY(asset->method) ? 1 : 2;
+}
+
+
+static double EVE_plan_duration(const EVE_asset_t *asset)
+{
+	return EVE_plan_max(asset->bus[asset->method], asset->chip[asset->method]);
+}
+
+
+static int EVE_plan_compare(const void *a, const void *b)
+{
+	const EVE_asset_t *first = a;
+	const EVE_asset_t *second = b;
+
+	if(EVE_plan_group(first) != EVE_plan_group(second))
+	{
+		return EVE_plan_group(first) - EVE_plan_group(second);
+	}
+
+	if(EVE_plan_duration(first) != EVE_plan_duration(second))
+	{
+		return (EVE_plan_duration(first) < EVE_plan_duration(second)) ? -1 : 1;
+	}
+
+	return strcmp(first->name, second->name);
+}
+
+
+/* puts the assets into the order they are issued and sets the times they start and end */
+static void EVE_plan_schedule(void)
+{
+	double bus = 0.0, chip_time = 0.0, fifo;
+	EVE_asset_t *asset;
+	int index;
+
+	qsort(assets, (size_t) assets_count, sizeof(EVE_asset_t), EVE_plan_compare);
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+
+		if(EVE_plan_group(asset) == 0)
+		{
+			asset->start = chip_time;
+			chip_time += EVE_plan_duration(asset);
+			asset->end = chip_time;
+		}
+		else if(EVE_plan_group(asset) == 1)
+		{
+			asset->start = bus;
+			bus += EVE_plan_duration(asset);
+			asset->end = bus;
+		}
+	}
+
+	fifo = EVE_plan_max(bus, chip_time);
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+
+		if(EVE_plan_group(asset) == 2)
+		{
+			asset->start = fifo;
+			fifo += EVE_plan_duration(asset);
+			asset->end = fifo;
+		}
+	}
+}
+
+
+static uint32_t EVE_plan_bus_bytes(const EVE_asset_t *asset)
+{
+	switch(asset->method)
+	{
+		case EVE_PLAN_RAW:
+			return asset->size;
+		case EVE_PLAN_DEFLATE:
+			return (asset->packed + 3UL) & ~3UL;
+		case EVE_PLAN_LOADIMAGE:
+			return (asset->file + 3UL) & ~3UL;
+		default:
+			return 0;
+	}
+}
+
+
+static uint32_t EVE_plan_flash_bytes(const EVE_asset_t *asset)
+{
+	switch(asset->method)
+	{
+		case EVE_PLAN_FLASHREAD:
+			return asset->size;
+		case EVE_PLAN_FLASH_INFLATE:
+			return asset->packed;
+		case EVE_PLAN_FLASH_LOADIMAGE:
+			return asset->file;
+		default:
+			return 0;
+	}
+}
+
+
+static int EVE_plan_write(const char *path, const EVE_link_t *link, double total)
+{
+	FILE *file = fopen(path, "w");
+	const EVE_asset_t *asset;
+	int index;
+
+	if(file == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	fprintf(file, "# generated by eve_plan for %s\n", chip->name);
+	fprintf(file, "# bus %.0f B/s, inflate %.0f B/s, jpeg %.0f px/s, png %.0f px/s, flash %.0f B/s, command %.0f us\n",
+		link->bus, link->inflate, link->jpeg, link->png, link->flash, link->command * 1e6);
+	fprintf(file, "# total %.0f us\n", total * 1e6);
+	fprintf(file, "step,name,method,format,width,height,size,bus_bytes,flash_bytes,start_us,end_us\n");
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+		fprintf(file, "%d,%s,%s,%s,%u,%u,%u,%u,%u,%.0f,%.0f\n", index + 1, asset->name, methods[asset->method],
+			EVE_asset_format(asset->format)->name, asset->width, asset->height, asset->size,
+			EVE_plan_bus_bytes(asset), EVE_plan_flash_bytes(asset), asset->start * 1e6, asset->end * 1e6);
+	}
+
+	if(fclose(file) != 0)
+	{
+		perror(path);
+		return -1;
+	}
+
+	return 0;
+}
+
+
+static void EVE_plan_usage(void)
+{
+	fprintf(stderr, "usage: eve_plan [-t FT80x|FT81x|BT81x] [-s hz] [-l lanes] [-r bytes] [-i bytes] [-J pixels] [-P pixels] [-f] [-F bytes] [-w us] [-o file] [-j jobs] name:FORMAT:file[:WIDTHxHEIGHT] ...\n");
+	fprintf(stderr, "FORMAT is one of L1, L2, L4, L8, RGB565, ARGB1555, ARGB4, PALETTED or RAW\n");
+}
+
+
+int main(int argc, char *argv[])
+{
+	EVE_link_t link = {0.0, EVE_PLAN_INFLATE, EVE_PLAN_JPEG, EVE_PLAN_PNG, EVE_PLAN_FLASH, EVE_PLAN_COMMAND * 1e-6};
+	const char *output = NULL;
+	const EVE_asset_t *asset;
+	uint32_t spi_hz = 20000000UL;
+	uint8_t lanes = 1, flash = 0;
+	double total, rate = 0.0;
+	long jobs;
+	int option, index;
+	size_t entry;
+
+	jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+	while((option = getopt(argc, argv, "t:s:l:r:i:J:P:fF:w:o:j:h")) != -1)
+	{
+		switch(option)
+		{
+			case 't':
+				chip = NULL;
+
+				for(entry = 0; entry < (sizeof(chips) / sizeof(chips[0])); entry++)
+				{
+					if(strcasecmp(optarg, chips[entry].name) == 0)
+					{
+						chip = &chips[entry];
+					}
+				}
+
+				if(chip == NULL)
+				{
+					EVE_plan_usage();
+					return 1;
+				}
+				break;
+
+			case 's':
+				spi_hz = (uint32_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'l':
+				lanes = (uint8_t) strtoul(optarg, NULL, 0);
+				break;
+
+			case 'r':
+				rate = strtod(optarg, NULL);
+				break;
+
+			case 'i':
+				link.inflate = strtod(optarg, NULL);
+				break;
+
+			case 'J':
+				link.jpeg = strtod(optarg, NULL);
+				break;
+
+			case 'P':
+				link.png = strtod(optarg, NULL);
+				break;
+
+			case 'f':
+				flash = 1;
+				break;
+
+			case 'F':
+				link.flash = strtod(optarg, NULL);
+				break;
+
+			case 'w':
+				link.command = strtod(optarg, NULL) * 1e-6;
+				break;
+
+			case 'o':
+				output = optarg;
+				break;
+
+			case 'j':
+				jobs = strtol(optarg, NULL, 0);
+				break;
+
+			default:
+				EVE_plan_usage();
+				return 1;
+		}
+	}
+
+	if((spi_hz == 0) || ((lanes != 1) && (lanes != 2) && (lanes != 4)) || (link.inflate <= 0.0) || (link.jpeg <= 0.0) ||
+		(link.png <= 0.0) || (link.flash <= 0.0) || (link.command < 0.0))
+	{
+		EVE_plan_usage();
+		return 1;
+	}
+
+	if(flash && (chip->flash == 0))
+	{
+		fprintf(stderr, "flash needs a BT81x\n");
+		return 1;
+	}
+
+	link.bus = (rate > 0.0) ? rate : (1.0 / EVE_deflate_bus_time(1, spi_hz, lanes));
+	assets_count = argc - optind;
+
+	if(assets_count <= 0)
+	{
+		EVE_plan_usage();
+		return 1;
+	}
+
+	if(jobs < 1)
+	{
+		jobs = 1;
+	}
+
+	assets = calloc((size_t) assets_count, sizeof(EVE_asset_t));
+
+	if(assets == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	for(index = 0; index < assets_count; index++)
+	{
+		if(EVE_plan_parse(argv[optind + index], &assets[index]) != 0)
+		{
+			fprintf(stderr, "%s: expected name:FORMAT:file[:WIDTHxHEIGHT]\n", argv[optind + index]);
+			return 1;
+		}
+
+		if(EVE_plan_measure(&assets[index], (unsigned) jobs) != 0)
+		{
+			return 1;
+		}
+
+		EVE_plan_costs(&assets[index], &link, flash);
+	}
+
+	printf("%-16s %-10s %9s %10s %10s %10s\n", "name", "format", "size", "packed", "file", "raw ms");
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+		printf("%-16s %-10s %4ux%-4u %10u %10u %10u %10.2f\n", asset->name, EVE_asset_format(asset->format)->name, asset->width, asset->height,
+			asset->size, asset->packed, asset->file, asset->usable[EVE_PLAN_RAW] ? (asset->bus[EVE_PLAN_RAW] * 1e3) : 0.0);
+	}
+
+	printf("\nall raw %.2f ms, all inflate %.2f ms", EVE_plan_all(EVE_PLAN_RAW) * 1e3, EVE_plan_all(EVE_PLAN_DEFLATE) * 1e3);
+
+	if(flash)
+	{
+		printf(", all from flash %.2f ms", EVE_plan_all(EVE_PLAN_FLASHREAD) * 1e3);
+	}
+
+	total = EVE_plan_optimize();
+	EVE_plan_schedule();
+	printf("\nplan %.2f ms\n\n", total * 1e3);
+	printf("%-4s %-16s %-16s %10s %10s %10s %10s\n", "step", "name", "method", "bus", "flash", "start ms", "end ms");
+
+	for(index = 0; index < assets_count; index++)
+	{
+		asset = &assets[index];
+		printf("%-4d %-16s %-16s %10u %10u %10.2f %10.2f\n", index + 1, asset->name, methods[asset->method],
+			EVE_plan_bus_bytes(asset), EVE_plan_flash_bytes(asset), asset->start * 1e3, asset->end * 1e3);
+	}
+
+	if((output != NULL) && (EVE_plan_write(output, &link, total) != 0))
+	{
+		return 1;
+	}
+
+	return 0;
+}